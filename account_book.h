@@ -0,0 +1,278 @@
+#pragma once
+
+// 科目增量汇总：运行合计 + 按金额有序的索引（红黑树）
+//
+// 单个科目更新 O(log n)：从有序索引中删掉旧键、插入新键、合计加上差值。
+// 金额和合计都是定点数（分），增量维护的合计与重新求和逐分相等，不会随更新次数漂移。
+// 占比不再存储，绘制时按 amount / total 现算。
+//
+// 也可以直接打开快照（冻结模式）：各列映射自文件，已按金额降序排好，id 即名次，
+// 打开不需要建索引；第一次修改时才解冻成上面的可变结构。
+
+#include <QColor>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <utility>
+#include "money.h"
+#include "snapshot.h"
+#include "string_pool.h"
+
+struct AccountItem {
+    QString name;
+    Money amount;         // 金额（分，图表按万元显示）
+    QString trend;        // 趋势：↑增长 ↓下降 →平稳
+    QColor color;         // 专属颜色
+};
+
+class AccountBook {
+public:
+    void reset(const QVector<AccountItem>& items) {
+        m_frozen.reset();
+        m_items = items;
+        m_index.clear();
+        m_order.clear();
+        m_total = Money();
+        for (int id = 0; id < m_items.size(); ++id) {
+            m_index.insert(m_items[id].name, id);
+            m_order.insert({m_items[id].amount.fen(), id});
+            m_total += m_items[id].amount;
+        }
+        m_rankDirty = true;
+        ++m_version;
+    }
+
+    int size() const { return m_frozen ? int(m_frozen->amounts.size()) : m_items.size(); }
+    bool empty() const { return size() == 0; }
+    bool isFrozen() const { return m_frozen != nullptr; }
+
+    // 冻结模式下现组装（只在格式化可见项时调用）；只要金额用 amount()
+    AccountItem at(int id) const {
+        if (!m_frozen) return m_items[id];
+        const Frozen& f = *m_frozen;
+        return {f.strings.view(f.names[id]).toString(), Money::fromFen(f.amounts[id]),
+                trendText(f.trends[id]), QColor::fromRgba(f.colors[id])};
+    }
+
+    Money amount(int id) const { return m_frozen ? Money::fromFen(m_frozen->amounts[id]) : m_items[id].amount; }
+
+    // 冻结模式没有名称索引，退化为线性查找
+    int find(const QString& name) const {
+        if (!m_frozen) return m_index.value(name, -1);
+        for (int id = 0; id < size(); ++id)
+            if (m_frozen->strings.view(m_frozen->names[id]) == name) return id;
+        return -1;
+    }
+
+    Money total() const { return m_total; }
+    // 占比（%）
+    double ratio(int id) const { return amount(id).ratio(m_total) * 100; }
+    Money maxAmount() const {
+        if (m_frozen) return Money::fromFen(m_frozen->amounts.empty() ? 0 : m_frozen->amounts.front());
+        return Money::fromFen(m_order.empty() ? 0 : m_order.begin()->first);
+    }
+
+    // 每次数据变化递增，供缓存判断是否失效
+    quint64 version() const { return m_version; }
+
+    // 新科目追加，已有科目更新金额；返回科目 id
+    int setAmount(const QString& name, Money amount) {
+        thaw();
+        int id = find(name);
+        if (id < 0) {
+            id = m_items.size();
+            m_items.append({name, amount, "→", QColor()});
+            m_index.insert(name, id);
+            m_order.insert({amount.fen(), id});
+            m_total += amount;
+            m_rankDirty = true;
+            ++m_version;
+            return id;
+        }
+        setAmount(id, amount);
+        return id;
+    }
+
+    void setAmount(int id, Money amount) {
+        thaw();
+        AccountItem& item = m_items[id];
+        if (item.amount == amount) return;
+
+        auto it = m_order.find({item.amount.fen(), id});
+        int prevId = it == m_order.begin() ? -1 : std::prev(it)->second;
+        int nextId = std::next(it) == m_order.end() ? -1 : std::next(it)->second;
+        m_order.erase(it);
+
+        m_total += amount - item.amount;
+        item.amount = amount;
+        it = m_order.insert({amount.fen(), id}).first;
+
+        // 相邻元素没变，名次也没变，排名快照仍然有效
+        int newPrev = it == m_order.begin() ? -1 : std::prev(it)->second;
+        int newNext = std::next(it) == m_order.end() ? -1 : std::next(it)->second;
+        if (newPrev != prevId || newNext != nextId) m_rankDirty = true;
+        ++m_version;
+    }
+
+    void setTrend(int id, const QString& trend) { thaw(); m_items[id].trend = trend; ++m_version; }
+    void setColor(int id, const QColor& color) { thaw(); m_items[id].color = color; ++m_version; }
+
+    // 金额前 n 名，O(n)
+    QVector<int> topN(int n) const {
+        QVector<int> ids;
+        ids.reserve(qMin(n, size()));
+        if (m_frozen) {
+            for (int id = 0; id < qMin(n, size()); ++id) ids.append(id);
+            return ids;
+        }
+        for (auto it = m_order.begin(); it != m_order.end() && ids.size() < n; ++it)
+            ids.append(it->second);
+        return ids;
+    }
+
+    // 第 rank 名的科目 id；名次变化后首次访问时按有序索引重建快照（无需排序）
+    int idAtRank(int rank) const {
+        if (m_frozen) return rank;
+        if (m_rankDirty) {
+            m_ranks.resize(0);
+            m_ranks.reserve(m_items.size());
+            for (const auto& key : m_order) m_ranks.append(key.second);
+            m_rankDirty = false;
+        }
+        return m_ranks[rank];
+    }
+
+    // 上次 idAtRank() 之后名次是否变过（改金额前先取一次快照，改完据此判断）
+    bool rankStale() const { return m_rankDirty; }
+
+    template <typename F>
+    void forEachInOrder(F f) const {
+        if (m_frozen) {
+            for (int id = 0; id < size(); ++id) f(id, id);
+            return;
+        }
+        int rank = 0;
+        for (const auto& key : m_order) f(rank++, key.second);
+    }
+
+    // 写快照：按名次顺序写出金额（分）/名称/趋势/颜色列和合计
+    bool writeSnapshot(const QString& path, QString* error = nullptr) const {
+        const int n = size();
+        std::vector<qint64> amounts(size_t(n), 0);
+        std::vector<quint32> names(size_t(n), 0);
+        std::vector<quint8> trends(size_t(n), 0);
+        std::vector<quint32> colors(size_t(n), 0);
+        StringPool strings;
+        forEachInOrder([&](int rank, int id) {
+            AccountItem item = at(id);
+            amounts[rank] = item.amount.fen();
+            names[rank] = strings.intern(item.name);
+            trends[rank] = trendCode(item.trend);
+            colors[rank] = item.color.rgba();
+        });
+
+        std::vector<quint32> offsets;
+        std::vector<char16_t> chars;
+        SnapshotWriter w(SnapshotFile::Finance);
+        const qint64 total = m_total.fen();
+        w.add("AFEN", amounts);
+        w.add("NAME", names);
+        w.add("TRND", trends);
+        w.add("COLR", colors);
+        w.add("TFEN", &total, 1);
+        strings.writeSnapshot(w, offsets, chars);
+        return w.finish(path, error);
+    }
+
+    // 打开快照进入冻结模式：只映射，不解析、不建索引；失败时保持原数据
+    bool openSnapshot(const QString& path, QString* error = nullptr) {
+        std::shared_ptr<SnapshotFile> file = SnapshotFile::open(path, SnapshotFile::Finance, error);
+        if (!file) return false;
+
+        std::unique_ptr<Frozen> f(new Frozen);
+        qint64 totalCount = 0;
+        const qint64* total = file->section<qint64>("TFEN", &totalCount);
+        bool ok = total && totalCount == 1
+                  && SnapshotFile::mapColumn(file, "AFEN", f->amounts)
+                  && SnapshotFile::mapColumn(file, "NAME", f->names)
+                  && SnapshotFile::mapColumn(file, "TRND", f->trends)
+                  && SnapshotFile::mapColumn(file, "COLR", f->colors)
+                  && f->names.size() == f->amounts.size()
+                  && f->trends.size() == f->amounts.size()
+                  && f->colors.size() == f->amounts.size()
+                  && f->strings.mapSnapshot(file)
+                  && SnapshotFile::allBelow(f->names, f->strings.size());
+        if (!ok) {
+            if (error) *error = "快照缺少科目列或数据损坏";
+            return false;
+        }
+
+        m_items.clear();
+        m_index.clear();
+        m_order.clear();
+        m_ranks.clear();
+        m_frozen = std::move(f);
+        m_total = Money::fromFen(*total);
+        m_rankDirty = true;
+        ++m_version;
+        return true;
+    }
+
+private:
+    // 快照列，已按金额降序（与 ByAmountDesc 一致）
+    struct Frozen {
+        Column<qint64> amounts;             // 分
+        Column<quint32> names;
+        Column<quint8> trends;
+        Column<quint32> colors;
+        StringPool strings;
+    };
+
+    static quint8 trendCode(const QString& trend) {
+        if (trend == "↑") return 1;
+        if (trend == "↓") return 2;
+        return 0;
+    }
+
+    static QString trendText(quint8 code) {
+        static const QString texts[] = {"→", "↑", "↓"};
+        return texts[code < 3 ? code : 0];
+    }
+
+    // 冻结模式第一次修改前，把映射的列展开成可变结构；列已有序，插入有序索引时直接追加到末尾
+    void thaw() {
+        if (!m_frozen) return;
+        std::unique_ptr<Frozen> f = std::move(m_frozen);
+        const int n = int(f->amounts.size());
+        m_items.resize(n);
+        m_index.reserve(n);
+        for (int id = 0; id < n; ++id) {
+            m_items[id] = {f->strings.view(f->names[id]).toString(), Money::fromFen(f->amounts[id]),
+                           trendText(f->trends[id]), QColor::fromRgba(f->colors[id])};
+            m_index.insert(m_items[id].name, id);
+            m_order.insert(m_order.end(), {f->amounts[id], id});
+        }
+        m_rankDirty = true;
+    }
+
+    // 金额降序，金额相同按 id 升序
+    struct ByAmountDesc {
+        bool operator()(const std::pair<qint64, int>& a, const std::pair<qint64, int>& b) const {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        }
+    };
+
+    QVector<AccountItem> m_items;                       // 按 id 存储，id 稳定
+    QHash<QString, int> m_index;                        // 名称 -> id
+    std::set<std::pair<qint64, int>, ByAmountDesc> m_order;    // (分, id)
+    Money m_total;
+    quint64 m_version = 0;
+
+    mutable QVector<int> m_ranks;                       // 名次 -> id 快照
+    mutable bool m_rankDirty = true;
+
+    std::unique_ptr<Frozen> m_frozen;                   // 非空时为冻结模式
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+// 动画时钟与帧时间统计
+//
+// AnimationClock 给出动画已运行的时间（可暂停，恢复后相位连续），动画状态由时间算出，
+// 计时器抖动或掉帧只会让画面少一帧，不会变慢。
+// FrameStats 把相邻两帧的间隔记入 0.25ms 一格的直方图，给出 p50/p99、最大值和掉帧数，
+// 可以取摘要文本，也可以导出 JSON。
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+#include <QtGlobal>
+#include <array>
+
+class AnimationClock {
+public:
+    void start() {
+        if (m_running) return;
+        m_timer.start();
+        m_running = true;
+    }
+
+    void stop() {
+        if (!m_running) return;
+        m_pausedNs += m_timer.nsecsElapsed();
+        m_running = false;
+    }
+
+    bool isRunning() const { return m_running; }
+
+    qint64 elapsedNs() const { return m_pausedNs + (m_running ? m_timer.nsecsElapsed() : 0); }
+    double seconds() const { return elapsedNs() / 1e9; }
+
+private:
+    QElapsedTimer m_timer;
+    qint64 m_pausedNs = 0;      // 之前各段运行时间之和
+    bool m_running = false;
+};
+
+class FrameStats {
+public:
+    static constexpr double kBucketMs = 0.25;
+    static constexpr int kBuckets = 400;        // 0 ~ 100ms，更长的记入最后一格
+
+    // 期望帧间隔（刷新周期）；间隔超过 1.5 倍即算掉帧
+    void setExpectedInterval(double ms) { m_expectedMs = ms; }
+    double expectedInterval() const { return m_expectedMs; }
+
+    void addFrame(double intervalMs) {
+        ++m_frames;
+        m_totalMs += intervalMs;
+        m_maxMs = qMax(m_maxMs, intervalMs);
+        ++m_histogram[size_t(qBound(0, int(intervalMs / kBucketMs), kBuckets))];
+        if (m_expectedMs > 0 && intervalMs > m_expectedMs * 1.5)
+            m_dropped += qMax(1, qRound(intervalMs / m_expectedMs) - 1);
+    }
+
+    void clear() {
+        m_histogram.fill(0);
+        m_frames = 0;
+        m_dropped = 0;
+        m_totalMs = 0;
+        m_maxMs = 0;
+    }
+
+    qint64 frames() const { return m_frames; }
+    qint64 droppedFrames() const { return m_dropped; }
+    double meanMs() const { return m_frames ? m_totalMs / m_frames : 0; }
+    double maxMs() const { return m_maxMs; }
+
+    // 按直方图取分位数，返回所在格的上沿（精度 0.25ms）
+    double quantileMs(double q) const {
+        if (m_frames == 0) return 0;
+        const qint64 rank = qMin(m_frames - 1, qint64(q * m_frames));
+        qint64 seen = 0;
+        for (int b = 0; b < kBuckets; ++b) {
+            seen += m_histogram[size_t(b)];
+            if (seen > rank) return (b + 1) * kBucketMs;
+        }
+        return m_maxMs;
+    }
+
+    QString summary() const {
+        return QString("帧数 %1, 平均 %2 ms, p50 %3 ms, p99 %4 ms, 最大 %5 ms, 掉帧 %6 (刷新周期 %7 ms)")
+                .arg(m_frames)
+                .arg(meanMs(), 0, 'f', 2)
+                .arg(quantileMs(0.50), 0, 'f', 2)
+                .arg(quantileMs(0.99), 0, 'f', 2)
+                .arg(m_maxMs, 0, 'f', 2)
+                .arg(m_dropped)
+                .arg(m_expectedMs, 0, 'f', 2);
+    }
+
+    // 汇总 + 非空的直方图格 {"ms": 格下沿, "count": 帧数}
+    bool writeJson(const QString& path) const {
+        QJsonArray buckets;
+        for (int b = 0; b <= kBuckets; ++b) {
+            if (m_histogram[size_t(b)] == 0) continue;
+            buckets.append(QJsonObject{{"ms", b * kBucketMs}, {"count", m_histogram[size_t(b)]}});
+        }
+
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) return false;
+        file.write(QJsonDocument(QJsonObject{{"frames", m_frames},
+                                             {"dropped", m_dropped},
+                                             {"expected_ms", m_expectedMs},
+                                             {"mean_ms", meanMs()},
+                                             {"p50_ms", quantileMs(0.50)},
+                                             {"p99_ms", quantileMs(0.99)},
+                                             {"max_ms", m_maxMs},
+                                             {"histogram", buckets}}).toJson());
+        return true;
+    }
+
+private:
+    std::array<qint64, kBuckets + 1> m_histogram{};
+    qint64 m_frames = 0;
+    qint64 m_dropped = 0;
+    double m_totalMs = 0;
+    double m_maxMs = 0;
+    double m_expectedMs = 1000.0 / 60;
+};
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <QWidget>
+#include <QPainter>
+#include <QPainterPath>
+#include <QLineF>
+#include <QVector>
+#include <QPaintEvent>
+#include <QImage>
+#include <QScreen>
+#include <QWindow>
+#include <QTimer>
+#include <cmath>
+#include "animation_clock.h"
+#include "bagua_tables.h"
+#include "taiji_sprite.h"
+#include "viz_text_cache.h"
+
+// 太极八卦图
+//
+// 只有太极盘在转：八卦符号、卦名、标题画进一张静态缓存层，太极盘预渲染成贴图（TaijiSprite），
+// 每帧只重绘太极盘所在的方块（静态层按脏区拷贝 + 旋转贴图），不再整窗重绘。
+// 转角由动画时钟按时间算出；计时器按屏幕刷新周期触发，上一帧没画完、窗口隐藏/最小化/
+// 被完全遮挡时跳过，各帧间隔记入 FrameStats。
+// 64 卦模式在太极外画一圈六爻卦（伏羲圆图次序）。卦表和爻线几何在编译期生成（bagua_tables.h），
+// 尺寸变化时缩放平移进 QLineF 缓冲，画静态层时一次 drawLines 画完。
+class BaguaDiagram : public QWidget {
+private:
+    double rotation = 0.0;
+    bool animate = true;
+    QTimer *timer;
+    QFont nameFont;     // 卦名字体
+    QFont titleFont;    // 标题字体
+    QImage staticLayer; // 八卦符号 + 卦名 + 标题，尺寸/DPR 变化时重建
+    TaijiSprite taiji;  // 太极盘贴图（精确或 mip 级数）
+    AnimationClock clock;       // 动画时间，停止时暂停
+    FrameStats frameStats;      // 动画帧间隔
+    QElapsedTimer frameTimer;
+    qint64 lastFrameNs = -1;    // 上一动画帧的时刻，-1 表示重新开始计
+    bool framePending = false;  // 已请求重绘、还没画
+    bool showHexagrams = false; // 64 卦模式
+    QSize geometrySize;         // 下面两圈爻线对应的尺寸
+    QVector<QLineF> trigramLines;   // 八卦一圈的全部爻线
+    QVector<QLineF> hexagramLines;  // 六十四卦一圈（384 爻）
+
+    static constexpr double kDegreesPerSecond = 31.25;  // 原先每 16ms 转 0.5°
+
+public:
+    BaguaDiagram(QWidget *parent = nullptr) : QWidget(parent) {
+        setWindowTitle("太极八卦图");
+        resize(700, 750);
+
+        timer = new QTimer(this);
+        timer->setTimerType(Qt::PreciseTimer);
+        timer->setInterval(16);     // 显示时按所在屏幕的刷新率调整
+        connect(timer, &QTimer::timeout, [this]() { tick(); });
+
+        frameTimer.start();
+        if (animate) {
+            clock.start();
+            timer->start();
+        }
+
+        setStyleSheet("background: #0c2461;");
+
+        // 字体只构造一次，不在绘制循环里重复创建
+        nameFont = font();
+        nameFont.setPointSize(8);
+        titleFont = font();
+        titleFont.setPointSize(20);
+        titleFont.setBold(true);
+    }
+
+    void toggleAnimation() {
+        animate = !animate;
+        if (animate) {
+            clock.start();
+            timer->start();
+        } else {
+            clock.stop();
+            timer->stop();
+        }
+        lastFrameNs = -1;
+        framePending = false;
+        update(taijiRect());    // 停止时太极盘回到原位
+    }
+
+    // 八卦 / 64 卦切换：只需重建静态层，太极盘和爻线缓冲不变
+    void setHexagramMode(bool on) {
+        if (on == showHexagrams) return;
+        showHexagrams = on;
+        staticLayer = QImage();
+        update();
+    }
+
+    bool isHexagramMode() const { return showHexagrams; }
+
+    const FrameStats &frameStatistics() const { return frameStats; }
+    void resetFrameStatistics() {
+        frameStats.clear();
+        lastFrameNs = -1;
+    }
+
+    // 太极盘占据的方块（含描边），旋转不改变它；动画每帧只重绘这里
+    QRect taijiRect() const {
+        int half = qCeil(TaijiSprite::extent(radius()));
+        return QRect(center() - QPoint(half, half), QSize(half * 2, half * 2));
+    }
+
+    // 太极贴图改用 mip 级数：改变窗口大小时复用已画好的最近一级，不再重新栅格化
+    void setTaijiMipmaps(bool on) {
+        taiji.setMode(on ? TaijiSprite::Mipmapped : TaijiSprite::Exact);
+        update(taijiRect());
+    }
+
+protected:
+    void paintEvent(QPaintEvent *e) override {
+        if (framePending) recordFrame();
+
+        QPainter painter(this);
+        const qreal dpr = painter.device()->devicePixelRatioF();
+        ensureLayers(dpr);
+        if (staticLayer.isNull()) return;
+
+        // 静态层只按脏区 1:1 拷贝
+        const QRect dirty = e->rect();
+        painter.drawImage(QRectF(dirty), staticLayer,
+                          QRectF(QPointF(dirty.topLeft()) * dpr, QSizeF(dirty.size()) * dpr));
+
+        // 太极盘贴图绕中心旋转
+        if (!dirty.intersects(taijiRect())) return;
+        if (animate) rotation = std::fmod(clock.seconds() * kDegreesPerSecond, 360.0);
+        painter.translate(center());
+        if (animate) {
+            painter.setRenderHint(QPainter::SmoothPixmapTransform);
+            painter.rotate(rotation);
+        }
+        taiji.draw(painter, radius(), dpr);
+    }
+
+    void showEvent(QShowEvent *e) override {
+        // 刷新周期取所在屏幕的；定时器略快于刷新，多出的触发被 framePending 合并掉
+        qreal hz = screen() ? screen()->refreshRate() : 60;
+        if (hz <= 0) hz = 60;
+        frameStats.setExpectedInterval(1000.0 / hz);
+        timer->setInterval(qMax(1, int(1000.0 / hz)));
+        lastFrameNs = -1;
+        if (animate) timer->start();
+        QWidget::showEvent(e);
+    }
+
+    void hideEvent(QHideEvent *e) override {
+        timer->stop();
+        framePending = false;
+        QWidget::hideEvent(e);
+    }
+
+private:
+    // 定时器触发：能看见且上一帧已画完时才请求下一帧
+    void tick() {
+        QWindow *handle = window()->windowHandle();
+        if (framePending) return;
+        if (window()->isMinimized() || (handle && !handle->isExposed()) || visibleRegion().isEmpty()) {
+            lastFrameNs = -1;   // 恢复显示后的第一帧不算掉帧
+            return;
+        }
+        framePending = true;
+        update(taijiRect());
+    }
+
+    void recordFrame() {
+        framePending = false;
+        const qint64 now = frameTimer.nsecsElapsed();
+        if (lastFrameNs >= 0) frameStats.addFrame((now - lastFrameNs) / 1e6);
+        lastFrameNs = now;
+    }
+
+    int radius() const { return qMin(width(), height()) / 3; }
+    QPoint center() const { return QPoint(width() / 2, height() / 2); }
+
+    void ensureLayers(qreal dpr) {
+        const QSize pixelSize = (QSizeF(size()) * dpr).toSize();
+        if (staticLayer.size() == pixelSize && staticLayer.devicePixelRatio() == dpr) return;
+        if (pixelSize.isEmpty()) {
+            staticLayer = QImage();
+            return;
+        }
+
+        staticLayer = QImage(pixelSize, QImage::Format_ARGB32_Premultiplied);
+        staticLayer.setDevicePixelRatio(dpr);
+        staticLayer.fill(Qt::transparent);
+        QPainter p(&staticLayer);
+        p.setRenderHint(QPainter::Antialiasing);
+        if (showHexagrams) {
+            drawHexagrams(p);
+        } else {
+            drawTrigrams(p);
+        }
+        drawTitle(p);
+    }
+
+    // 编译期的单位空间几何 -> 当前尺寸的像素坐标：只做缩放和平移
+    template <int Capacity>
+    static void scaleRing(const bagua::Ring<Capacity> &ring, QPointF c, double r, QVector<QLineF> &out) {
+        out.resize(ring.size);
+        for (int i = 0; i < ring.size; i++) {
+            const bagua::RingPoint &a = ring.lines[i].a;
+            const bagua::RingPoint &b = ring.lines[i].b;
+            out[i] = QLineF(c.x() + r * a.ux + a.px, c.y() + r * a.uy + a.py,
+                            c.x() + r * b.ux + b.px, c.y() + r * b.uy + b.py);
+        }
+    }
+
+    // 两圈爻线只在尺寸变化时重算
+    void ensureGeometry() {
+        if (geometrySize == size()) return;
+        geometrySize = size();
+        scaleRing(bagua::kTrigramRing, center(), radius(), trigramLines);
+        scaleRing(bagua::kHexagramRing, center(), radius(), hexagramLines);
+    }
+
+    void drawTrigrams(QPainter &painter) {
+        int cx = center().x();
+        int cy = center().y();
+        int r = radius();
+
+        // 八卦符号：一次画完全部爻线
+        ensureGeometry();
+        painter.setPen(vizPen(QColor(255,215,0), 2));
+        painter.drawLines(trigramLines);
+
+        // 名称
+        painter.setFont(nameFont);
+        painter.setPen(Qt::white);
+        for (int i = 0; i < bagua::kTrigramCount; i++) {
+            const bagua::Direction &dir = bagua::kTrigramDirections[i];
+            int tx = cx + r * bagua::kTrigramStyle.dist * dir.x;
+            int ty = cy + r * bagua::kTrigramStyle.dist * dir.y;
+
+            painter.save();
+            painter.translate(tx, ty);
+            painter.rotate(dir.degrees);
+            drawCachedText(painter, -40, 40, 80, 40, Qt::AlignCenter, QString::fromUtf8(bagua::kTrigramNames[i]));
+            painter.restore();
+        }
+    }
+
+    void drawHexagrams(QPainter &painter) {
+        ensureGeometry();
+        painter.setPen(vizPen(QColor(255,215,0), 1.5));
+        painter.drawLines(hexagramLines);
+    }
+
+    void drawTitle(QPainter &painter) {
+        painter.setPen(Qt::yellow);
+        painter.setFont(titleFont);
+        drawCachedText(painter, rect(), Qt::AlignTop | Qt::AlignHCenter,
+                       showHexagrams ? "太极六十四卦图" : "太极八卦图");
+    }
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+// 八卦 / 六十四卦的编译期数据
+//
+// 卦用位掩码表示：第 j 位是第 j 爻（0 为初爻），1 阳 0 阴。
+// 两圈卦符的方向角和爻线端点都在编译期算好（constexpr 三角函数），端点存成
+// "半径倍数 + 像素偏移" 两部分：实际坐标 = 圆心 + r * unit + pixel，
+// 尺寸变化时只需对静态数组做一次缩放和平移。
+
+#include <QtGlobal>
+#include <array>
+
+namespace bagua {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// 泰勒级数，先把角度归约到 [-π, π]，误差远小于一个像素
+constexpr double sine(double x) {
+    while (x > kPi) x -= 2 * kPi;
+    while (x < -kPi) x += 2 * kPi;
+    double term = x;
+    double sum = x;
+    for (int n = 1; n <= 12; ++n) {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cosine(double x) { return sine(x + kPi / 2); }
+
+// 乾 坤 震 坎 艮 巽 离 兑
+constexpr int kTrigramCount = 8;
+constexpr quint8 kTrigrams[kTrigramCount] = {0b111, 0b000, 0b001, 0b010, 0b100, 0b011, 0b101, 0b110};
+constexpr const char* kTrigramNames[kTrigramCount] = {
+        "乾 天 西北", "坤 地 西南", "震 雷 东", "坎 水 北",
+        "艮 山 东北", "巽 风 东南", "离 火 南", "兑 泽 西"
+};
+
+// 八卦从正上方起顺时针每 45° 一个
+constexpr double trigramAngle(int i) { return i * kPi / 4 - kPi / 2; }
+
+// 卦名的摆放方向：径向单位向量 + 文字旋转角（度，文字底边朝外）
+struct Direction {
+    double x = 0, y = 0;
+    double degrees = 0;
+};
+
+constexpr std::array<Direction, kTrigramCount> makeTrigramDirections() {
+    std::array<Direction, kTrigramCount> dirs{};
+    for (int i = 0; i < kTrigramCount; ++i)
+        dirs[i] = {cosine(trigramAngle(i)), sine(trigramAngle(i)), trigramAngle(i) * 180 / kPi + 90};
+    return dirs;
+}
+
+constexpr auto kTrigramDirections = makeTrigramDirections();
+
+// 伏羲六十四卦圆图：乾在顶，左半圈逆时针 乾→复，右半圈顺时针 姤→坤。
+// 圆图次序按"初爻为最高位"的二进制递减（乾 63、复 32、姤 31、坤 0），这里换成爻位掩码。
+constexpr int kHexagramCount = 64;
+
+constexpr double hexagramAngle(int k) {
+    return -kPi / 2 + (k < 32 ? -1 : 1) * (k % 32 + 0.5) * (2 * kPi / kHexagramCount);
+}
+
+constexpr quint8 hexagramAt(int k) {
+    const int value = k < 32 ? 63 - k : 31 - (k - 32);
+    quint8 mask = 0;
+    for (int j = 0; j < 6; ++j) mask |= quint8(((value >> (5 - j)) & 1) << j);
+    return mask;
+}
+
+// 位置 = 圆心 + r * (ux, uy) + (px, py)
+struct RingPoint {
+    double ux = 0, uy = 0;
+    double px = 0, py = 0;
+};
+
+struct RingLine {
+    RingPoint a, b;
+};
+
+// 一圈卦符的全部爻线，阴爻拆成两段，所以容量按每爻两段算
+template <int Capacity>
+struct Ring {
+    RingLine lines[Capacity] = {};
+    int size = 0;
+};
+
+// 卦符的摆放：第 j 爻离圆心 dist - (y0 + j * spacing)，第 0 爻在最外
+struct SymbolStyle {
+    double dist;        // 卦中心离圆心，r 的倍数
+    double halfWidth;   // 爻的半宽
+    double gap;         // 阴爻中间缺口的一半
+    double y0;
+    double spacing;
+    bool pixels;        // true: halfWidth/gap/y0/spacing 是像素；false: 是 r 的倍数
+};
+
+template <int Capacity>
+constexpr void appendSymbol(Ring<Capacity>& ring, double angle, quint8 mask, int lines, const SymbolStyle& s) {
+    const double rx = cosine(angle), ry = sine(angle);     // 径向
+    const double tx = -ry, ty = rx;                         // 切向
+    auto at = [&](double along, double across) {
+        const double x = rx * along + tx * across;
+        const double y = ry * along + ty * across;
+        RingPoint p;
+        p.ux = rx * s.dist + (s.pixels ? 0 : x);
+        p.uy = ry * s.dist + (s.pixels ? 0 : y);
+        p.px = s.pixels ? x : 0;
+        p.py = s.pixels ? y : 0;
+        return p;
+    };
+    for (int j = 0; j < lines; ++j) {
+        const double along = -(s.y0 + j * s.spacing);
+        if ((mask >> j) & 1) {
+            ring.lines[ring.size++] = {at(along, -s.halfWidth), at(along, s.halfWidth)};   // 实线
+        } else {
+            ring.lines[ring.size++] = {at(along, -s.halfWidth), at(along, -s.gap)};        // 虚线1
+            ring.lines[ring.size++] = {at(along, s.gap), at(along, s.halfWidth)};          // 虚线2
+        }
+    }
+}
+
+// 八卦一圈：卦中心在 1.2r，爻长 40px、爻距 20px（不随半径缩放）
+constexpr SymbolStyle kTrigramStyle = {1.2, 20, 5, -30, 20, true};
+
+constexpr Ring<kTrigramCount * 3 * 2> makeTrigramRing() {
+    Ring<kTrigramCount * 3 * 2> ring;
+    for (int i = 0; i < kTrigramCount; ++i) appendSymbol(ring, trigramAngle(i), kTrigrams[i], 3, kTrigramStyle);
+    return ring;
+}
+
+// 六十四卦一圈：卦中心在 1.22r，卦宽取弧长的八成，六爻总高约一个弧长，全部随半径缩放
+constexpr double kHexagramArc = 1.22 * 2 * kPi / kHexagramCount;
+constexpr SymbolStyle kHexagramStyle = {1.22, kHexagramArc * 0.4, kHexagramArc * 0.08,
+                                        -2.5 * kHexagramArc * 0.18, kHexagramArc * 0.18, false};
+
+constexpr Ring<kHexagramCount * 6 * 2> makeHexagramRing() {
+    Ring<kHexagramCount * 6 * 2> ring;
+    for (int k = 0; k < kHexagramCount; ++k) appendSymbol(ring, hexagramAngle(k), hexagramAt(k), 6, kHexagramStyle);
+    return ring;
+}
+
+constexpr auto kTrigramRing = makeTrigramRing();
+constexpr auto kHexagramRing = makeHexagramRing();
+
+static_assert(kTrigramRing.size == 8 * 3 + 12, "八卦共 12 个阴爻");
+static_assert(kHexagramRing.size == 384 + 192, "六十四卦阴阳爻各半");
+
+} // namespace bagua
@@ -0,0 +1,299 @@
+#pragma once
+
+// 柱状图节点
+//
+// 放得下带标签的柱子时逐项绘制：每根柱的矩形、渐变画刷、数值/名称文字在重建时算好。
+// 项数超过容量时切换到分桶 LOD（见 BarLod），每个颜色分组一条包络路径，路径也在重建时生成。
+// 数据项须按值从大到小排列，第 0 项即最大值（Y 轴上限）。
+// 重建时顺带按列登记命中区间（见 SpanIndex），鼠标悬停只查这张表。
+
+#include <QLinearGradient>
+#include <vector>
+#include "bar_lod.h"
+#include "chart_scene.h"
+#include "hit_index.h"
+
+class BarChartNode : public ChartNode {
+public:
+    // 逐项模式下一根柱子的内容
+    struct Bar {
+        double value = 0;
+        QGradientStops stops;       // 柱体自上而下的渐变
+        QColor highlight;           // 顶部高光条，无效色不画
+        QString valueText;          // 柱顶数值
+        QString label;              // 底部名称
+        QString badge;              // 数值上方的小标记（如趋势箭头）
+        QColor badgeColor;
+    };
+
+    // LOD 模式下一个颜色分组：包络渐变（上/下）和桶内最小值的颜色
+    struct BandColors {
+        QColor top, bottom, min;
+    };
+
+    struct Style {
+        int barWidth = 30;
+        int spacing = 15;
+        int leftInset = 40;         // 绘图区左边离边框
+        int rightInset = 10;
+        int bottomInset = 40;
+        int heightInset = 80;       // 绘图区高度 = 边框高度 - heightInset
+        int valueGap = 20;          // 数值标签顶端在柱顶之上多少
+        int valueHeight = 15;
+        int valueWiden = 0;         // 数值标签每侧比柱子宽出多少
+        bool rotatedLabels = true;  // 名称旋转 45° 并截断到 10 字，否则在柱下居中折行
+        int tickLength = 5;
+        int tickLabelGap = 0;       // 刻度文字右端到刻度线左端
+        int tickLabelWidth = 35;
+        int tickDecimals = 1;
+        QColor tickColor = QColor(200, 200, 200, 150);
+        QColor axisColor;           // 无效色不画坐标轴
+        QString lodCaption = "共 %1 项，每列约 %2 项";
+    };
+
+    Style style;
+
+    // 数据绑定
+    std::function<int()> count;
+    std::function<Bar(int)> bar;                    // 逐项模式，只对前 capacity() 项调用
+    std::function<double(int)> value;               // LOD 模式
+    std::function<int(int)> band;                   // LOD 颜色分组，可空
+    std::function<BandColors(int)> bandColors;
+    std::function<QString()> emptyText;             // 没有数据时的提示，可空
+
+    using ChartNode::ChartNode;
+
+    // 逐项模式最多能放的柱数
+    int capacity() const {
+        const Layout l = layout();
+        return (l.right - l.left + style.spacing) / (style.barWidth + style.spacing);
+    }
+
+    // 最大值和名次都没变、只有第 index 根柱子的值变了：只重绘它那一列
+    void invalidateBar(int index) {
+        if (style.rotatedLabels) {      // 斜标签会伸到相邻的列
+            invalidate();
+            return;
+        }
+        const Layout l = layout();
+        const int x = l.left + index * (style.barWidth + style.spacing) - style.spacing / 2;
+        invalidate(QRect(x, bounds().top(), style.barWidth + style.spacing, bounds().height()));
+    }
+
+    // 鼠标命中：逐项模式为一根柱子，LOD 模式为一列（一个桶，[first, last] 为桶内各项）
+    ChartHit hitTest(const QPoint& pos) const {
+        if (!isVisible() || !bounds().contains(pos)) return {};
+        const int slot = m_hits.find(pos.x());
+        if (slot < 0) return {};
+        if (!m_lod) return {slot, slot, slot};
+        return {m_barLod.firstItem(slot), m_barLod.firstItem(slot + 1) - 1, slot};
+    }
+
+    // 命中项的高亮轮廓，取自缓存的柱子矩形或分桶高度
+    QPainterPath hitShape(const ChartHit& hit) const {
+        QPainterPath path;
+        if (!m_lod) {
+            if (hit.slot < 0 || hit.slot >= int(m_bars.size())) return path;
+            path.addRoundedRect(QRectF(m_bars[size_t(hit.slot)].rect).adjusted(-3, -3, 3, 0), 6, 6);
+        } else {
+            const QVector<BarBucket>& buckets = m_barLod.buckets();
+            if (hit.slot < 0 || hit.slot >= buckets.size() || m_max <= 0) return path;
+            const QRectF& plot = m_layout.plot;
+            const double pitch = plot.width() / buckets.size();
+            const double h = qBound(0.0, buckets[hit.slot].max / m_max * plot.height(), plot.height());
+            path.addRect(QRectF(plot.left() + hit.slot * pitch - 1, plot.bottom() - h - 1, qMax(pitch, 1.0) + 2, h + 1));
+        }
+        return path;
+    }
+
+    void paint(QPainter& p) const override {
+        paintFrame(p);
+        if (m_count == 0) {
+            if (!m_emptyText.isEmpty()) {
+                p.setPen(QColor(200, 220, 255, 180));
+                p.setFont(vizFont(11));
+                drawCachedText(p, bounds(), Qt::AlignCenter, m_emptyText);
+            }
+            return;
+        }
+
+        const Layout& l = m_layout;
+        if (m_lod) {
+            // 包络（每列最大值）用渐变，桶内最小值用实色，每个分组各一次 drawPath
+            p.setPen(Qt::NoPen);
+            for (int b = 0; b < int(m_bandBrushes.size()); ++b) {
+                p.setBrush(m_bandBrushes[b]);
+                p.drawPath(m_barLod.maxPath(b, l.plot, m_max));
+                p.setBrush(m_bandMin[b]);
+                p.drawPath(m_barLod.minPath(b, l.plot, m_max));
+            }
+
+            // 聚合说明（代替逐项标签）
+            p.setPen(QColor(200, 220, 255, 180));
+            p.setFont(vizFont(9));
+            drawCachedText(p, l.plot.adjusted(0, 0, -4, 0), Qt::AlignTop | Qt::AlignRight, m_caption);
+        } else {
+            for (const CachedBar& c : m_bars) paintBar(p, c);
+        }
+
+        // Y轴刻度
+        p.setPen(style.tickColor);
+        p.setFont(vizFont(9));
+        const int labelRight = l.left - style.tickLength - style.tickLabelGap;
+        for (int i = 0; i <= 5; ++i) {
+            int y = l.bottom - l.chartHeight * i / 5.0;
+            p.drawLine(l.left - style.tickLength, y, l.left, y);
+            drawCachedText(p, labelRight - style.tickLabelWidth, y - 10, style.tickLabelWidth, 20,
+                           Qt::AlignRight | Qt::AlignVCenter, m_ticks[i]);
+        }
+
+        // 轴线
+        if (style.axisColor.isValid()) {
+            p.setPen(vizPen(style.axisColor, 1.5));
+            p.drawLine(l.left, bounds().top() + 30, l.left, l.bottom);
+            p.drawLine(l.left, l.bottom, l.right, l.bottom);
+        }
+    }
+
+protected:
+    void rebuild() override {
+        m_layout = layout();
+        m_count = count ? count() : 0;
+        m_emptyText = emptyText ? emptyText() : QString();
+        m_bars.clear();
+        m_bandBrushes.clear();
+        m_bandMin.clear();
+        m_hits.clear();
+        if (m_count == 0) return;
+
+        const Layout& l = m_layout;
+        m_lod = m_count > capacity();
+        if (m_lod) {
+            // 只有数据变化才会重建，分桶每次按新版本号重算
+            m_max = value(0);
+            m_barLod.update(++m_revision, m_count, int(l.plot.width()), value,
+                            band ? band : std::function<int(int)>([](int) { return 0; }));
+            for (int b = 0; b < m_barLod.bandCount(); ++b) {
+                const BandColors colors = bandColors(b);
+                QLinearGradient grad(0, l.plot.top(), 0, l.plot.bottom());
+                grad.setColorAt(0, colors.top);
+                grad.setColorAt(1, colors.bottom);
+                m_bandBrushes.push_back(QBrush(grad));
+                m_bandMin.push_back(colors.min);
+            }
+            m_barLod.maxPath(0, l.plot, m_max);     // 路径在这里生成，paint() 只读
+            m_caption = style.lodCaption.arg(m_count)
+                    .arg(double(m_count) / m_barLod.buckets().size(), 0, 'f', 1);
+
+            const int columns = m_barLod.buckets().size();
+            const double pitch = l.plot.width() / columns;
+            m_hits.reserve(columns);
+            for (int c = 0; c < columns; ++c) m_hits.add(l.plot.left() + c * pitch, l.plot.left() + (c + 1) * pitch, c);
+        } else {
+            m_bars.resize(size_t(m_count));
+            m_hits.reserve(m_count);
+            for (int i = 0; i < m_count; ++i) {
+                Bar b = bar(i);
+                if (i == 0) m_max = b.value;
+                const int height = m_max > 0 ? int(b.value / m_max * l.chartHeight) : 0;
+                const int x = l.left + i * (style.barWidth + style.spacing);
+
+                CachedBar& c = m_bars[size_t(i)];
+                c.rect = QRect(x, l.bottom - height, style.barWidth, height);
+                QLinearGradient grad(x, l.bottom - height, x, l.bottom);
+                grad.setStops(b.stops);
+                c.brush = QBrush(grad);
+                c.highlight = b.highlight;
+                c.valueText = std::move(b.valueText);
+                c.label = std::move(b.label);
+                if (style.rotatedLabels && c.label.length() > 10) c.label = c.label.left(8) + "...";
+                c.badge = std::move(b.badge);
+                c.badgeColor = b.badgeColor;
+                m_hits.add(x, x + style.barWidth, i);
+            }
+        }
+
+        for (int i = 0; i <= 5; ++i)
+            m_ticks[i] = QString::number(m_max * i / 5.0, 'f', style.tickDecimals);
+    }
+
+private:
+    struct Layout {
+        int left = 0, right = 0, bottom = 0, chartHeight = 0;
+        QRectF plot;        // LOD 绘图区
+    };
+
+    struct CachedBar {
+        QRect rect;
+        QBrush brush;
+        QColor highlight;
+        QString valueText;
+        QString label;
+        QString badge;
+        QColor badgeColor;
+    };
+
+    Layout m_layout;
+    int m_count = 0;
+    double m_max = 0;
+    bool m_lod = false;
+    quint64 m_revision = 0;
+    QString m_emptyText;
+    QString m_ticks[6];
+    std::vector<CachedBar> m_bars;          // 逐项模式
+    BarLod m_barLod;                        // LOD 模式
+    std::vector<QBrush> m_bandBrushes;
+    std::vector<QColor> m_bandMin;
+    QString m_caption;
+    SpanIndex m_hits;                       // 各柱 / 各列的 x 区间
+
+    Layout layout() const {
+        const QRect& a = bounds();
+        Layout l;
+        l.left = a.left() + style.leftInset;
+        l.right = a.right() - style.rightInset;
+        l.bottom = a.bottom() - style.bottomInset;
+        l.chartHeight = a.height() - style.heightInset;
+        l.plot = QRectF(l.left + 1, l.bottom - l.chartHeight, l.right - l.left - 1, l.chartHeight);
+        return l;
+    }
+
+    void paintBar(QPainter& p, const CachedBar& c) const {
+        p.setPen(Qt::NoPen);
+        p.setBrush(c.brush);
+        p.drawRoundedRect(c.rect, 5, 5);
+
+        // 顶部高光条
+        if (c.highlight.isValid()) {
+            p.setBrush(c.highlight);
+            p.drawRect(c.rect.left() + 2, c.rect.top(), style.barWidth - 4, 8);
+        }
+
+        // 柱顶数值
+        p.setPen(Qt::white);
+        p.setFont(vizFont(10, QFont::Bold));
+        drawCachedText(p, c.rect.left() - style.valueWiden, c.rect.top() - style.valueGap,
+                       style.barWidth + 2 * style.valueWiden, style.valueHeight, Qt::AlignCenter, c.valueText);
+
+        // 底部名称
+        if (style.rotatedLabels) {
+            p.save();
+            p.translate(c.rect.left() + style.barWidth / 2, m_layout.bottom + 10);
+            p.rotate(-45);  // 旋转45度避免重叠
+            p.setFont(vizFont(8));
+            drawCachedText(p, -50, 0, 100, 20, Qt::AlignCenter, c.label);
+            p.restore();
+        } else {
+            p.setFont(vizFont(9));
+            drawCachedText(p, c.rect.left() - style.spacing / 2, m_layout.bottom + 5,
+                           style.barWidth + style.spacing, 40, Qt::AlignCenter | Qt::TextWordWrap, c.label);
+        }
+
+        if (!c.badge.isEmpty()) {
+            p.setPen(c.badgeColor);
+            p.setFont(vizFont(12, QFont::Bold));
+            drawCachedText(p, c.rect.left() + style.barWidth / 2 - 5, c.rect.top() - style.valueGap - 20,
+                           20, 20, Qt::AlignCenter, c.badge);
+        }
+    }
+};
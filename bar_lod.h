@@ -0,0 +1,131 @@
+#pragma once
+
+// 柱状图细节层次(LOD)
+//
+// 项数超过像素预算时，把相邻项合并到每个像素列一个桶（min/max/sum），
+// 同一颜色分组的所有列拼成一条 QPainterPath 一次绘制，不再逐项画柱和标签。
+// 绘制开销只取决于图表宽度，与项数无关。
+
+#include <QPainterPath>
+#include <QRectF>
+#include <QVector>
+#include <algorithm>
+
+struct BarBucket {
+    double min = 0;
+    double max = 0;
+    double sum = 0;
+    int count = 0;
+    int band = 0;        // 颜色分组（取桶内最大值所在项的分组）
+};
+
+class BarLod {
+public:
+    // 数据版本、项数或列数变化时重建分桶；value(i) 取第 i 项的值，band(i) 取颜色分组
+    template <typename Value, typename Band>
+    void update(quint64 version, int count, int columns, Value value, Band band) {
+        if (count <= 0) {
+            m_version = version;
+            m_count = 0;
+            m_buckets.clear();
+            m_pathsPlot = QRectF();
+            return;
+        }
+        columns = qMax(1, qMin(count, columns));
+        if (version == m_version && count == m_count && columns == m_buckets.size()) return;
+
+        m_version = version;
+        m_count = count;
+        m_buckets.resize(columns);
+        m_pathsPlot = QRectF();
+
+        for (int c = 0; c < columns; ++c) {
+            int begin = firstItem(c);
+            int end = firstItem(c + 1);
+
+            BarBucket b;
+            b.min = b.max = value(begin);
+            int maxIndex = begin;
+            for (int i = begin; i < end; ++i) {
+                double v = value(i);
+                b.sum += v;
+                if (v < b.min) b.min = v;
+                if (v > b.max) { b.max = v; maxIndex = i; }
+            }
+            b.count = end - begin;
+            b.band = band(maxIndex);
+            m_buckets[c] = b;
+        }
+    }
+
+    template <typename Value>
+    void update(quint64 version, int count, int columns, Value value) {
+        update(version, count, columns, value, [](int) { return 0; });
+    }
+
+    const QVector<BarBucket>& buckets() const { return m_buckets; }
+
+    // 第 column 列（桶）的第一项；第 column 列覆盖 [firstItem(column), firstItem(column + 1))
+    int firstItem(int column) const { return int(qint64(column) * m_count / m_buckets.size()); }
+
+    // band 分组的包络(max)路径；plot 为绘图区，maxValue 对应 plot 顶部
+    const QPainterPath& maxPath(int band, const QRectF& plot, double maxValue) const {
+        ensurePaths(plot, maxValue);
+        return m_maxPaths[band];
+    }
+
+    // band 分组的下沿(min)路径，画在包络之上显示桶内跨度
+    const QPainterPath& minPath(int band, const QRectF& plot, double maxValue) const {
+        ensurePaths(plot, maxValue);
+        return m_minPaths[band];
+    }
+
+    int bandCount() const {
+        int n = 0;
+        for (const BarBucket& b : m_buckets) n = qMax(n, b.band + 1);
+        return n;
+    }
+
+private:
+    quint64 m_version = ~0ull;
+    int m_count = -1;
+    QVector<BarBucket> m_buckets;
+
+    // 路径缓存：分桶或绘图区变化时重建
+    mutable QRectF m_pathsPlot;
+    mutable double m_pathsMax = 0;
+    mutable QVector<QPainterPath> m_maxPaths;
+    mutable QVector<QPainterPath> m_minPaths;
+
+    void ensurePaths(const QRectF& plot, double maxValue) const {
+        if (plot == m_pathsPlot && maxValue == m_pathsMax) return;
+        m_pathsPlot = plot;
+        m_pathsMax = maxValue;
+
+        int bands = qMax(1, bandCount());
+        m_maxPaths = QVector<QPainterPath>(bands);
+        m_minPaths = QVector<QPainterPath>(bands);
+        if (m_buckets.isEmpty() || maxValue <= 0) return;
+
+        double pitch = plot.width() / m_buckets.size();
+        double gap = pitch >= 3 ? 1 : 0;     // 列足够宽时留 1px 缝
+        double scale = plot.height() / maxValue;
+
+        for (int c = 0; c < m_buckets.size(); ++c) {
+            const BarBucket& b = m_buckets[c];
+            double x = plot.left() + c * pitch;
+            double hMax = qBound(0.0, b.max * scale, plot.height());
+            double hMin = qBound(0.0, b.min * scale, plot.height());
+            m_maxPaths[b.band].addRect(QRectF(x, plot.bottom() - hMax, pitch - gap, hMax));
+            m_minPaths[b.band].addRect(QRectF(x, plot.bottom() - hMin, pitch - gap, hMin));
+        }
+
+        // QPainterPath 的包围盒是惰性计算的，这里先算好，之后多线程同时 drawPath 只读
+        for (int i = 0; i < bands; ++i) {
+            m_maxPaths[i].controlPointRect();
+            m_maxPaths[i].boundingRect();
+            m_minPaths[i].controlPointRect();
+            m_minPaths[i].boundingRect();
+        }
+    }
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+// 无界面批量出图
+//
+// 输入目录下每个数据文件生成一张报表（PNG 或 PDF）。每个报表在线程池里独立完成：
+// 新建看板对象 -> 导入数据 -> 画到该线程自己的 QImage 上 -> 保存。
+// 需配合 offscreen 平台插件运行（QT_QPA_PLATFORM=offscreen），不需要显示器。
+// 每个报表的耗时和总吞吐量写入汇总 JSON。
+
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QStringList>
+#include <QThread>
+#include <QThreadPool>
+#include <functional>
+#include <vector>
+
+struct BatchOptions {
+    QString inputDir;
+    QString outputDir;
+    QStringList nameFilters;          // 例如 {"*.csv", "*.glb"}
+    QString format = "png";           // png 或 pdf
+    QSize size{1100, 750};
+    qreal dpr = 1.0;
+    int threads = QThread::idealThreadCount();
+    QString summaryPath;              // 为空时写到 outputDir/batch_summary.json
+
+    // 解析 --input --output --format --threads --dpr --summary；--batch 本身由调用方判断
+    static BatchOptions fromArguments(const QStringList& args) {
+        BatchOptions o;
+        auto value = [&args](const QString& name) {
+            int i = args.indexOf(name);
+            return i >= 0 && i + 1 < args.size() ? args[i + 1] : QString();
+        };
+        o.inputDir = value("--input");
+        o.outputDir = value("--output").isEmpty() ? o.inputDir : value("--output");
+        if (!value("--format").isEmpty()) o.format = value("--format").toLower();
+        if (!value("--threads").isEmpty()) o.threads = qMax(1, value("--threads").toInt());
+        if (!value("--dpr").isEmpty()) o.dpr = qMax(0.5, value("--dpr").toDouble());
+        o.summaryPath = value("--summary");
+        return o;
+    }
+};
+
+struct BatchReport {
+    QString input;
+    QString output;
+    bool ok = false;
+    double loadMs = 0;
+    double renderMs = 0;
+    double saveMs = 0;
+};
+
+// Dashboard 需提供 setSize(QSize) 和 render(QPainter&, QRect dirty, qreal dpr)
+template <typename Dashboard>
+int runBatch(const BatchOptions& opt, std::function<bool(Dashboard&, const QString&)> load) {
+    QDir in(opt.inputDir);
+    const QFileInfoList files = in.entryInfoList(opt.nameFilters, QDir::Files, QDir::Name);
+    if (files.isEmpty()) {
+        qDebug() << "批量出图: 输入目录没有数据文件" << opt.inputDir;
+        return 1;
+    }
+    QDir().mkpath(opt.outputDir);
+
+    std::vector<BatchReport> reports(files.size());
+    QThreadPool pool;
+    pool.setMaxThreadCount(opt.threads);
+
+    QElapsedTimer wall;
+    wall.start();
+
+    for (int i = 0; i < files.size(); ++i) {
+        pool.start([&, i] {
+            BatchReport& r = reports[i];
+            r.input = files[i].absoluteFilePath();
+            r.output = QDir(opt.outputDir).filePath(files[i].completeBaseName() + "." + opt.format);
+
+            QElapsedTimer t;
+            t.start();
+            Dashboard dash;
+            bool loaded = load(dash, r.input);
+            r.loadMs = t.nsecsElapsed() / 1e6;
+            if (!loaded) return;
+
+            // 每个工作线程一张图、一个 QPainter
+            t.restart();
+            dash.setSize(opt.size);
+            QImage image((QSizeF(opt.size) * opt.dpr).toSize(), QImage::Format_ARGB32_Premultiplied);
+            image.setDevicePixelRatio(opt.dpr);
+            image.fill(Qt::black);
+            {
+                QPainter p(&image);
+                dash.render(p, QRect(QPoint(0, 0), opt.size), opt.dpr);
+            }
+            r.renderMs = t.nsecsElapsed() / 1e6;
+
+            t.restart();
+            if (opt.format == "pdf") {
+                QPdfWriter pdf(r.output);
+                pdf.setPageSize(QPageSize(QSizeF(opt.size), QPageSize::Point));
+                pdf.setPageMargins(QMarginsF(0, 0, 0, 0));
+                pdf.setResolution(qRound(72 * opt.dpr));
+                QPainter p(&pdf);
+                p.drawImage(QRect(QPoint(0, 0), image.size()), image);
+                r.ok = p.end();
+            } else {
+                r.ok = image.save(r.output);
+            }
+            r.saveMs = t.nsecsElapsed() / 1e6;
+        });
+    }
+    pool.waitForDone();
+    double wallSec = wall.nsecsElapsed() / 1e9;
+
+    // 汇总
+    QJsonArray items;
+    int okCount = 0;
+    double loadSum = 0, renderSum = 0, saveSum = 0;
+    for (const BatchReport& r : reports) {
+        items.append(QJsonObject{
+                {"input", r.input}, {"output", r.output}, {"ok", r.ok},
+                {"load_ms", r.loadMs}, {"render_ms", r.renderMs}, {"save_ms", r.saveMs}});
+        okCount += r.ok;
+        loadSum += r.loadMs;
+        renderSum += r.renderMs;
+        saveSum += r.saveMs;
+    }
+    int n = int(reports.size());
+    QJsonObject summary{
+            {"reports", n},
+            {"succeeded", okCount},
+            {"threads", opt.threads},
+            {"width", opt.size.width()},
+            {"height", opt.size.height()},
+            {"dpr", opt.dpr},
+            {"wall_seconds", wallSec},
+            {"reports_per_second", wallSec > 0 ? n / wallSec : 0},
+            {"avg_load_ms", loadSum / n},
+            {"avg_render_ms", renderSum / n},
+            {"avg_save_ms", saveSum / n},
+            {"items", items}};
+
+    QString summaryPath = opt.summaryPath.isEmpty()
+                          ? QDir(opt.outputDir).filePath("batch_summary.json") : opt.summaryPath;
+    QFile out(summaryPath);
+    if (out.open(QIODevice::WriteOnly)) out.write(QJsonDocument(summary).toJson());
+
+    qDebug().noquote() << QString("批量出图完成: %1/%2 成功, %3 秒, %4 张/秒, 汇总: %5")
+            .arg(okCount).arg(n)
+            .arg(wallSec, 0, 'f', 2)
+            .arg(wallSec > 0 ? n / wallSec : 0, 0, 'f', 1)
+            .arg(summaryPath);
+    return okCount == n ? 0 : 2;
+}
@@ -0,0 +1,400 @@
+// 绘制性能基准
+//
+// 把 FinanceDashboard / MedicalDashboard / BaguaDiagram 离屏画到 QImage 上计时，
+// 参数矩阵：DPR 1x/2x × 720p/4K × 数据量 10 ~ 1M。
+//
+// 用法:
+//   viz_bench [--out result.json] [--filter 子串] [--min-time 毫秒]
+//             [--compare baseline.json] [--threshold 0.10]
+// --compare 时任一用例中位数比基线慢超过阈值即返回 1，可直接用于 CI。
+
+#include <QApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QSysInfo>
+#include <QThread>
+#include <algorithm>
+#include <functional>
+#include "bagua.h"
+#include "financial.h"
+#include "hit_index.h"
+#include "medical_pricing_viz.h"
+#include "price_histogram.h"
+#include "tile_renderer.h"
+
+struct BenchResult {
+    QString name;
+    double firstMs = 0;     // 首帧（含缓存构建）
+    double medianMs = 0;    // 稳态帧
+    double minMs = 0;
+    double p90Ms = 0;
+    int iterations = 0;
+};
+
+static QVector<AccountItem> syntheticAccounts(int n) {
+    QRandomGenerator rng(42);
+    QVector<AccountItem> items;
+    items.reserve(n);
+    static const char* trends[] = {"↑", "↓", "→"};
+    for (int i = 0; i < n; ++i) {
+        double amount = std::exp(rng.generateDouble() * 8) / 10;   // 长尾分布
+        items.append({QString("科目%1").arg(i), Money::fromWan(amount), trends[i % 3], QColor()});
+    }
+    return items;
+}
+
+static QVector<Item> syntheticItems(int n) {
+    QRandomGenerator rng(7);
+    QVector<Item> items;
+    items.reserve(n);
+    static const char* names[] = {"一次性使用输液器 带针", "一次性使用无菌注射器 带针",
+                                  "一次性使用静脉输液针", "一次性使用无菌注射针"};
+    for (int i = 0; i < n; ++i) {
+        items.append({QString("%1 #%2").arg(names[i % 4]).arg(i),
+                      0.5 + rng.generateDouble() * 9.5,
+                      QString("%1ml 0.%2*25").arg(1 + i % 50).arg(45 + i % 30)});
+    }
+    return items;
+}
+
+// 先画一帧计首帧时间，然后至少跑 minTimeMs 毫秒（5~200 次）取稳态统计
+static BenchResult measure(const QString& name, int minTimeMs, const std::function<void()>& frame) {
+    BenchResult r;
+    r.name = name;
+
+    QElapsedTimer t;
+    t.start();
+    frame();
+    r.firstMs = t.nsecsElapsed() / 1e6;
+
+    QVector<double> samples;
+    QElapsedTimer total;
+    total.start();
+    while (samples.size() < 5 || (total.elapsed() < minTimeMs && samples.size() < 200)) {
+        t.restart();
+        frame();
+        samples.append(t.nsecsElapsed() / 1e6);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    r.iterations = samples.size();
+    r.minMs = samples.front();
+    r.medianMs = samples[samples.size() / 2];
+    r.p90Ms = samples[qMin(samples.size() - 1, int(samples.size() * 0.9))];
+    return r;
+}
+
+static QImage makeTarget(const QSize& size, qreal dpr) {
+    QImage image((QSizeF(size) * dpr).toSize(), QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(dpr);
+    image.fill(Qt::black);
+    return image;
+}
+
+// 与基线比较，返回是否存在超过阈值的退化
+static bool compareWithBaseline(const QVector<BenchResult>& results, const QString& path, double threshold) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "无法读取基线" << path;
+        return true;
+    }
+
+    QHash<QString, double> baseline;
+    for (const QJsonValue& v : QJsonDocument::fromJson(file.readAll()).object()["results"].toArray()) {
+        QJsonObject o = v.toObject();
+        baseline.insert(o["name"].toString(), o["median_ms"].toDouble());
+    }
+
+    bool regressed = false;
+    for (const BenchResult& r : results) {
+        if (!baseline.contains(r.name)) continue;
+        double base = baseline.value(r.name);
+        double change = base > 0 ? (r.medianMs - base) / base : 0;
+        const char* tag = change > threshold ? "退化" : (change < -threshold ? "提升" : "持平");
+        if (change > threshold) regressed = true;
+        printf("%-48s %10.3f -> %10.3f ms  %+6.1f%%  %s\n",
+               qPrintable(r.name), base, r.medianMs, change * 100, tag);
+    }
+    return regressed;
+}
+
+int main(int argc, char* argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    QApplication::setFont(QFont("Microsoft YaHei"));
+
+    QStringList args = app.arguments();
+    auto value = [&args](const QString& name, const QString& def = QString()) {
+        int i = args.indexOf(name);
+        return i >= 0 && i + 1 < args.size() ? args[i + 1] : def;
+    };
+    QString outPath = value("--out", "viz_bench.json");
+    QString filter = value("--filter");
+    QString baselinePath = value("--compare");
+    int minTimeMs = value("--min-time", "300").toInt();
+    double threshold = value("--threshold", "0.10").toDouble();
+
+    struct SizeCase { const char* name; QSize size; };
+    const SizeCase sizes[] = {{"720p", QSize(1280, 720)}, {"4k", QSize(3840, 2160)}};
+    const qreal dprs[] = {1.0, 2.0};
+    const int volumes[] = {10, 1000, 100000, 1000000};
+
+    QVector<BenchResult> results;
+    auto run = [&](const QString& name, const std::function<void()>& frame) {
+        if (!filter.isEmpty() && !name.contains(filter)) return;
+        BenchResult r = measure(name, minTimeMs, frame);
+        printf("%-48s first %9.3f  median %9.3f  p90 %9.3f ms  (%d)\n",
+               qPrintable(name), r.firstMs, r.medianMs, r.p90Ms, r.iterations);
+        fflush(stdout);
+        results.append(r);
+    };
+
+    for (int n : volumes) {
+        // 同一数据量只生成一次，各尺寸/DPR 共用；过滤到其他看板时跳过生成
+        QVector<AccountItem> accounts;
+        QVector<Item> items;
+        bool wantFinance = !filter.startsWith("medical") && !filter.startsWith("bagua");
+        bool wantMedical = !filter.startsWith("financial") && !filter.startsWith("bagua");
+        if (wantFinance) accounts = syntheticAccounts(n);
+        if (wantMedical) items = syntheticItems(n);
+
+        for (const SizeCase& sc : sizes) {
+            for (qreal dpr : dprs) {
+                QString suffix = QString("%1/dpr%2/n=%3").arg(sc.name).arg(dpr).arg(n);
+                QRect full(QPoint(0, 0), sc.size);
+
+                if (wantFinance) {
+                    FinanceDashboard dash;
+                    dash.setAccounts(accounts);
+                    dash.setSize(sc.size);
+                    QImage target = makeTarget(sc.size, dpr);
+                    run("financial/" + suffix, [&] {
+                        QPainter p(&target);
+                        dash.render(p, full, dpr);
+                    });
+
+                    // 分块并行，线程数取核数
+                    TileRenderer tiles;
+                    run("financial-tiled/" + suffix, [&] {
+                        QPainter p(&target);
+                        dash.render(p, full, dpr, &tiles);
+                    });
+                }
+
+                if (wantMedical) {
+                    MedicalDashboard dash;
+                    dash.setItems(items);
+                    dash.setSize(sc.size);
+                    QImage target = makeTarget(sc.size, dpr);
+                    run("medical/" + suffix, [&] {
+                        QPainter p(&target);
+                        dash.render(p, full, dpr);
+                    });
+                }
+            }
+        }
+    }
+
+    // 八卦图没有数据量维度
+    for (const SizeCase& sc : sizes) {
+        for (qreal dpr : dprs) {
+            BaguaDiagram bagua;
+            bagua.resize(sc.size);
+            bagua.ensurePolished();
+            QImage target = makeTarget(sc.size, dpr);
+            run(QString("bagua/%1/dpr%2").arg(sc.name).arg(dpr), [&] { bagua.render(&target); });
+
+            // 动画帧：只重绘太极盘方块
+            run(QString("bagua-frame/%1/dpr%2").arg(sc.name).arg(dpr), [&] {
+                bagua.render(&target, QPoint(), QRegion(bagua.taijiRect()));
+            });
+            bagua.setTaijiMipmaps(true);
+            run(QString("bagua-frame-mip/%1/dpr%2").arg(sc.name).arg(dpr), [&] {
+                bagua.render(&target, QPoint(), QRegion(bagua.taijiRect()));
+            });
+            bagua.setTaijiMipmaps(false);
+
+            // 64 卦模式整窗（首帧含爻线和静态层构建）
+            bagua.setHexagramMode(true);
+            run(QString("bagua-hex/%1/dpr%2").arg(sc.name).arg(dpr), [&] { bagua.render(&target); });
+        }
+    }
+
+    // 价格区间直方图：5000 万个 float 价格，固定边界与分位数边界
+    const QString histName = "histogram/n=50000000";
+    if (filter.isEmpty() || histName.contains(filter) || filter.startsWith("histogram")) {
+        QRandomGenerator rng(11);
+        std::vector<float> prices(50000000);
+        for (float& v : prices) v = float(0.5 + rng.generateDouble() * 9.5);
+
+        PriceHistogram hist;
+        run(histName + "/fixed", [&] { hist.compute(prices.data(), qint64(prices.size())); });
+        run(histName + "/quantile4", [&] {
+            hist.setEdges(PriceHistogram::quantileEdges(prices.data(), qint64(prices.size()), 4));
+            hist.compute(prices.data(), qint64(prices.size()));
+        });
+    }
+
+    // 金额聚合：5000 万条分录按分定点求和、按 1 万个科目分组求和；double 逐项累加作对照
+    const QString moneyName = "money/n=50000000";
+    if (filter.isEmpty() || moneyName.contains(filter) || filter.startsWith("money")) {
+        QRandomGenerator rng(13);
+        const int groups = 10000;
+        std::vector<qint64> fen(50000000);
+        std::vector<quint32> accounts(fen.size());
+        for (size_t i = 0; i < fen.size(); ++i) {
+            fen[i] = qint64(rng.bounded(10000000)) - 2000000;
+            accounts[i] = rng.bounded(groups);
+        }
+        std::vector<double> yuan(fen.size());
+        for (size_t i = 0; i < fen.size(); ++i) yuan[i] = fen[i] / 100.0;
+
+        volatile qint64 sinkFen = 0;
+        volatile double sinkYuan = 0;
+        run(moneyName + "/sum", [&] { sinkFen = Money::sumFen(fen.data(), qint64(fen.size())); });
+        run(moneyName + "/sum-double", [&] {
+            double total = 0;
+            for (double v : yuan) total += v;
+            sinkYuan = total;
+        });
+        std::vector<qint64> totals(groups);
+        run(moneyName + "/groupby10000", [&] {
+            std::fill(totals.begin(), totals.end(), 0);
+            Money::groupSumFen(accounts.data(), fen.data(), qint64(fen.size()), totals.data(), groups);
+        });
+    }
+
+    // 耗材搜索：200 万项，从空开始逐键输入 "注射器 1ml"（首次含建索引）
+    const QString searchName = "medical-search/n=2000000/type7";
+    if (filter.isEmpty() || searchName.contains(filter)) {
+        MedicalDashboard dash;
+        dash.setItems(syntheticItems(2000000));
+        const QString query = "注射器 1ml";
+        run(searchName, [&] {
+            dash.setFilter(QString());
+            for (int len = 1; len <= query.size(); ++len) dash.setFilter(query.left(len));
+        });
+    }
+
+    // 价格走势：一条 1000 万样本的序列（约 27 年，每天 1000 次报价），放大 10 级再缩回全程，
+    // 每帧只重建、重绘走势图
+    const QString historyName = "medical-history/n=10000000/zoom";
+    if (filter.isEmpty() || historyName.contains(filter)) {
+        QRandomGenerator rng(3);
+        std::vector<PricePoint> samples(10000000);
+        const qint32 firstDay = qint32(QDate(2000, 1, 1).toJulianDay());
+        float price = 5;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            price = qMax(0.1f, price + float(rng.generateDouble() - 0.5) * 0.02f);
+            samples[i] = {firstDay + qint32(i / 1000), price, price, price};
+        }
+
+        MedicalDashboard dash;
+        PriceHistory history;
+        const QString name = dash.catalog().name(0).toString();
+        const QString spec = dash.catalog().spec(0).toString();
+        history.addSeries(name, spec, std::move(samples));
+        dash.setPriceHistory(std::move(history));
+        dash.showHistory(0);
+        QImage target = makeTarget(QSize(1000, 750), 1.0);
+        {
+            QPainter p(&target);
+            dash.render(p, QRect(0, 0, 1000, 750), 1.0);
+        }
+
+        const int x = MedicalDashboard::pieChartArea().center().x();
+        int step = 0;
+        run(historyName, [&] {
+            dash.zoomHistory(step++ % 20 < 10 ? 0.5 : 2.0, x);
+            QPainter p(&target);
+            dash.render(p, dash.dirtyRegion().boundingRect(), 1.0);
+        });
+    }
+
+    // 悬停命中：100 万项的耗材看板先画一帧建好索引，鼠标在柱状图（LOD 分桶）和清单上交替移动
+    // 1 万次，含命中、取高亮形状和格式化提示（不重绘）；另测 100 万个区间的 SpanIndex 随机查 100 万次
+    const QString hoverName = "hover/n=1000000";
+    if (filter.isEmpty() || hoverName.contains(filter) || filter.startsWith("hover")) {
+        MedicalDashboard dash;
+        dash.setItems(syntheticItems(1000000));
+        QImage target = makeTarget(QSize(1000, 750), 1.0);
+        {
+            QPainter p(&target);
+            dash.render(p, QRect(0, 0, 1000, 750), 1.0);
+        }
+
+        const QRect areas[] = {MedicalDashboard::barChartArea(), MedicalDashboard::tableArea()};
+        int step = 0;
+        run(hoverName + "/dashboard-moves10000", [&] {
+            for (int i = 0; i < 10000; ++i, ++step) {
+                const QRect& a = areas[step % 2];
+                dash.hover(QPoint(a.left() + step * 7 % a.width(), a.top() + step * 13 % a.height()));
+            }
+        });
+
+        SpanIndex spans;
+        spans.reserve(1000000);
+        for (int i = 0; i < 1000000; ++i) spans.add(i * 1.5, i * 1.5 + 1.0, i);     // 区间之间留缝
+        QRandomGenerator rng(17);
+        std::vector<double> xs(1000000);
+        for (double& x : xs) x = rng.generateDouble() * 1500000;
+        volatile int sinkHits = 0;
+        run(hoverName + "/span-index-find1000000", [&] {
+            int hits = 0;
+            for (double x : xs) hits += spans.find(x) >= 0;
+            sinkHits = hits;
+        });
+    }
+
+    // 实时流水：200k 条/秒在 60Hz 下每帧约 3334 条，1 万个科目；解析入队 + 按帧合并 + 重绘脏区
+    const QString feedName = "financial-feed/200k-per-sec/accounts=10000";
+    if (filter.isEmpty() || feedName.contains(filter)) {
+        QRandomGenerator rng(5);
+        QByteArray journal;
+        for (int i = 0; i < 3334; ++i)
+            journal += QString("科目%1,%2\n").arg(rng.bounded(10000)).arg(rng.bounded(100000) / 100.0).toUtf8();
+
+        FinanceDashboard dash;
+        dash.setAccounts(syntheticAccounts(10000));
+        dash.setSize(QSize(1280, 720));
+        QImage target = makeTarget(QSize(1280, 720), 1.0);
+        LedgerFeed feed;
+        run(feedName, [&] {
+            feed.ingest(journal.constData(), journal.size());
+            dash.applyFeed(feed);
+            QPainter p(&target);
+            dash.render(p, dash.dirtyRegion().boundingRect(), 1.0);
+        });
+    }
+
+    // 输出 JSON
+    QJsonArray arr;
+    for (const BenchResult& r : results) {
+        arr.append(QJsonObject{{"name", r.name},
+                               {"first_ms", r.firstMs},
+                               {"median_ms", r.medianMs},
+                               {"min_ms", r.minMs},
+                               {"p90_ms", r.p90Ms},
+                               {"iterations", r.iterations}});
+    }
+    QJsonObject doc{{"meta", QJsonObject{{"qt", QT_VERSION_STR},
+                                         {"os", QSysInfo::prettyProductName()},
+                                         {"cpu", QSysInfo::currentCpuArchitecture()},
+                                         {"threads", QThread::idealThreadCount()},
+                                         {"date", QDateTime::currentDateTime().toString(Qt::ISODate)}}},
+                    {"results", arr}};
+    QFile out(outPath);
+    if (out.open(QIODevice::WriteOnly)) out.write(QJsonDocument(doc).toJson());
+    printf("结果已写入 %s\n", qPrintable(outPath));
+
+    if (!baselinePath.isEmpty()) return compareWithBaseline(results, baselinePath, threshold) ? 1 : 0;
+    return 0;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+// 耗材目录的增量搜索
+//
+// 查询按空白拆成若干词，每个词都要出现在名称或规格里（不区分大小写）。
+// 先在 n-gram 索引上求出每个词命中的字符串 id，再按各行的名称/规格 id 查标记表筛行。
+// 边输入边搜时新查询通常只是在旧查询后追加字符：每个旧词都是对应新词的子串时，
+// 新结果一定是旧结果的子集，字符串匹配和行筛选都只在上一次的结果里做。
+// 索引在第一次搜索时建立，数据变化后 invalidate() 丢弃，查询保留，下次用到时重算。
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+#include <utility>
+#include <vector>
+#include "catalog_store.h"
+#include "ngram_index.h"
+#include "snapshot.h"
+
+class CatalogSearch {
+public:
+    static constexpr int kMaxTokens = 8;    // 标记表每个字符串一个字节，多出的词忽略
+
+    // 数据或显示顺序变了：丢弃索引和结果，保留查询
+    void invalidate() {
+        m_index.clear();
+        m_names.clear();
+        m_specs.clear();
+        m_mask.clear();
+        m_stale = true;
+    }
+
+    // order 为显示顺序 -> 行号；结果是命中的显示位置（升序，即仍按显示顺序）
+    void setQuery(const QString& query, const CatalogStore& catalog, const Column<quint32>& order) {
+        QElapsedTimer timer;
+        timer.start();
+
+        QStringList tokens = query.simplified().split(' ', Qt::SkipEmptyParts);
+        if (tokens.size() > kMaxTokens) tokens = tokens.mid(0, kMaxTokens);
+        m_query = query;
+        if (tokens.isEmpty()) {
+            m_tokens.clear();
+            m_matches.clear();
+            m_positions.clear();
+            m_lastMs = 0;
+            return;
+        }
+        ensureIndex(catalog, order);
+
+        // 旧词都是新词的子串：结果只会变少
+        bool narrowing = !m_stale && !m_tokens.isEmpty() && tokens.size() >= m_tokens.size();
+        for (int t = 0; narrowing && t < m_tokens.size(); ++t)
+            narrowing = tokens[t].contains(m_tokens[t], Qt::CaseInsensitive);
+
+        std::vector<std::vector<quint32>> matches(size_t(tokens.size()));
+        for (int t = 0; t < tokens.size(); ++t) {
+            const bool known = !m_stale && t < m_tokens.size();
+            if (known && tokens[t].compare(m_tokens[t], Qt::CaseInsensitive) == 0)
+                matches[t] = std::move(m_matches[t]);
+            else if (known && tokens[t].contains(m_tokens[t], Qt::CaseInsensitive))
+                matches[t] = m_index.match(tokens[t], &m_matches[t]);
+            else
+                matches[t] = m_index.match(tokens[t]);
+        }
+        filterRows(matches, narrowing);
+
+        m_tokens = tokens;
+        m_matches = std::move(matches);
+        m_stale = false;
+        m_lastMs = timer.nsecsElapsed() / 1e6;
+    }
+
+    // invalidate() 之后按原查询重算
+    void refresh(const CatalogStore& catalog, const Column<quint32>& order) {
+        if (m_stale && active()) setQuery(m_query, catalog, order);
+    }
+
+    bool active() const { return !m_tokens.isEmpty(); }
+    const QString& query() const { return m_query; }
+    const std::vector<quint32>& positions() const { return m_positions; }
+    double lastQueryMs() const { return m_lastMs; }
+
+private:
+    NgramIndex m_index;
+    std::vector<quint32> m_names;       // 显示顺序的名称/规格 id，筛行时顺序读
+    std::vector<quint32> m_specs;
+    std::vector<quint8> m_mask;         // 字符串 id -> 命中的词（按位），用完清零
+
+    QString m_query;
+    QStringList m_tokens;
+    std::vector<std::vector<quint32>> m_matches;    // 每个词命中的字符串 id
+    std::vector<quint32> m_positions;
+    bool m_stale = true;
+    double m_lastMs = 0;
+
+    void ensureIndex(const CatalogStore& catalog, const Column<quint32>& order) {
+        if (!m_index.empty()) return;
+        QElapsedTimer timer;
+        timer.start();
+
+        m_index.build(catalog.strings());
+        const qint64 n = order.size();
+        m_names.resize(size_t(n));
+        m_specs.resize(size_t(n));
+        for (qint64 i = 0; i < n; ++i) {
+            m_names[i] = catalog.nameId(order[i]);
+            m_specs[i] = catalog.specId(order[i]);
+        }
+        m_mask.assign(size_t(catalog.strings().size()), 0);
+        m_stale = true;
+
+        qDebug().noquote() << QString("搜索索引: %1 条字符串, %2 ms, 约 %3 MB")
+                .arg(catalog.strings().size())
+                .arg(timer.nsecsElapsed() / 1e6, 0, 'f', 1)
+                .arg(m_index.memoryBytes() / (1024.0 * 1024.0), 0, 'f', 1);
+    }
+
+    void filterRows(const std::vector<std::vector<quint32>>& matches, bool narrowing) {
+        // 第 t 个词命中的字符串打上第 t 位
+        for (size_t t = 0; t < matches.size(); ++t)
+            for (quint32 id : matches[t]) m_mask[id] |= quint8(1u << t);
+        const quint8 all = quint8((1u << matches.size()) - 1);
+
+        std::vector<quint32> positions;
+        auto hit = [&](quint32 pos) { return quint8(m_mask[m_names[pos]] | m_mask[m_specs[pos]]) == all; };
+        if (narrowing) {
+            for (quint32 pos : m_positions)
+                if (hit(pos)) positions.push_back(pos);
+        } else {
+            for (quint32 pos = 0; pos < quint32(m_names.size()); ++pos)
+                if (hit(pos)) positions.push_back(pos);
+        }
+        m_positions.swap(positions);
+
+        for (const std::vector<quint32>& ids : matches)
+            for (quint32 id : ids) m_mask[id] = 0;
+    }
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+// 列式耗材目录
+//
+// 价格是连续的 double 列；名称和规格驻留(intern)在字符串池里，每行只存 32 位 id，
+// 大量重复的名称和规格（"一次性使用…带针"）只存一份。
+// 排序和筛选都作用在行号置换上，不搬动行数据；按价格排序只读价格列。
+// 各列也可以直接映射快照文件（只读），clear() 后回到可写的自有模式。
+
+#include <QStringView>
+#include <QtGlobal>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "snapshot.h"
+#include "string_pool.h"
+
+class CatalogStore {
+public:
+    void clear() {
+        m_prices.clear();
+        m_names.clear();
+        m_specs.clear();
+        m_strings.clear();
+    }
+
+    void reserve(qint64 rows) {
+        m_prices.mutableData().reserve(size_t(rows));
+        m_names.mutableData().reserve(size_t(rows));
+        m_specs.mutableData().reserve(size_t(rows));
+    }
+
+    // 映射模式下只读，需先 clear()
+    quint32 append(QStringView name, double price, QStringView spec) {
+        Q_ASSERT(!isMapped());
+        m_prices.mutableData().push_back(price);
+        m_names.mutableData().push_back(m_strings.intern(name));
+        m_specs.mutableData().push_back(m_strings.intern(spec));
+        return quint32(m_prices.size() - 1);
+    }
+
+    int size() const { return int(m_prices.size()); }
+    bool empty() const { return m_prices.empty(); }
+    bool isMapped() const { return m_strings.isMapped(); }
+
+    double price(quint32 row) const { return m_prices[row]; }
+    quint32 nameId(quint32 row) const { return m_names[row]; }
+    quint32 specId(quint32 row) const { return m_specs[row]; }
+    QStringView name(quint32 row) const { return m_strings.view(m_names[row]); }
+    QStringView spec(quint32 row) const { return m_strings.view(m_specs[row]); }
+
+    const Column<double>& prices() const { return m_prices; }
+    const StringPool& strings() const { return m_strings; }
+
+    // 映射快照里的 PRIC/NAME/SPEC 列和字符串池，不拷贝；名称/规格 id 须在池内
+    bool mapSnapshot(const std::shared_ptr<SnapshotFile>& file) {
+        clear();
+        bool ok = SnapshotFile::mapColumn(file, "PRIC", m_prices)
+                  && SnapshotFile::mapColumn(file, "NAME", m_names)
+                  && SnapshotFile::mapColumn(file, "SPEC", m_specs)
+                  && m_names.size() == m_prices.size() && m_specs.size() == m_prices.size()
+                  && m_strings.mapSnapshot(file)
+                  && SnapshotFile::allBelow(m_names, m_strings.size())
+                  && SnapshotFile::allBelow(m_specs, m_strings.size());
+        if (!ok) clear();
+        return ok;
+    }
+
+    // 满足条件的行号，保持录入顺序；pred(row) 返回 bool
+    template <typename Pred>
+    std::vector<quint32> select(Pred pred) const {
+        std::vector<quint32> rows;
+        for (quint32 r = 0; r < quint32(m_prices.size()); ++r)
+            if (pred(r)) rows.push_back(r);
+        return rows;
+    }
+
+    std::vector<quint32> allRows() const {
+        std::vector<quint32> rows(m_prices.size());
+        for (quint32 r = 0; r < quint32(rows.size()); ++r) rows[r] = r;
+        return rows;
+    }
+
+    // 行号置换按价格从高到低排序（同价按录入顺序）。
+    // 只取 (价格, 行号) 两列排序，不碰字符串；sortedPrices 非空时顺带输出排序后的连续价格列。
+    void sortByPriceDesc(std::vector<quint32>& rows, std::vector<double>* sortedPrices = nullptr) const {
+        std::vector<std::pair<double, quint32>> keys(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) keys[i] = {m_prices[rows[i]], rows[i]};
+        std::sort(keys.begin(), keys.end(), [](const std::pair<double, quint32>& a,
+                                               const std::pair<double, quint32>& b) {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        });
+
+        if (sortedPrices) sortedPrices->resize(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            rows[i] = keys[i].second;
+            if (sortedPrices) (*sortedPrices)[i] = keys[i].first;
+        }
+    }
+
+    // 每行固定开销 16 字节（价格 + 两个 id），字符串按去重后计；映射的列不计
+    qint64 memoryBytes() const {
+        return m_prices.memoryBytes() + m_names.memoryBytes() + m_specs.memoryBytes()
+               + m_strings.memoryBytes();
+    }
+
+private:
+    Column<double> m_prices;
+    Column<quint32> m_names;        // 字符串池 id
+    Column<quint32> m_specs;
+    StringPool m_strings;
+};
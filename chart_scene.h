@@ -0,0 +1,182 @@
+#pragma once
+
+// 保留模式图表场景
+//
+// 看板由若干节点（柱状图、饼图/环形图、表格、文字）组成。节点通过绑定函数取数，
+// 把由数据算出的几何、画刷和格式化字符串缓存起来，数据变化时只把受影响的节点标脏:
+//   - 各节点待重绘区域之和就是窗口需要 update() 的区域
+//   - 绘制前 sync() 只重建脏节点的缓存（单线程）
+//   - paint() 只读缓存，可以被分块渲染的多个线程同时调用
+// 没有变化的节点重绘时直接按缓存画，不再重新生成渐变、坐标和字符串。
+
+#include <QPainter>
+#include <QRect>
+#include <QRegion>
+#include <QString>
+#include <functional>
+#include <vector>
+#include "paint_profiler.h"
+#include "viz_text_cache.h"
+
+// 节点自带的圆角边框和标题；边框画在静态层里的看板不设置 fill
+struct ChartFrame {
+    QColor fill;                                // 无效色表示不画边框
+    QColor pen = QColor(100, 150, 255, 150);
+    int radius = 10;
+    QColor titleColor = Qt::white;
+    int titleSize = 14;
+
+    void paint(QPainter& p, const QRect& area, const QString& title) const {
+        if (fill.isValid()) {
+            p.setBrush(fill);
+            p.setPen(pen);
+            p.drawRoundedRect(area, radius, radius);
+        }
+        if (!title.isEmpty()) {
+            p.setPen(titleColor);
+            p.setFont(vizFont(titleSize, QFont::Bold));
+            drawCachedText(p, area.left(), area.top() - 5, area.width(), 30, Qt::AlignCenter, title);
+        }
+    }
+};
+
+class ChartNode {
+public:
+    ChartNode(const char* name, const QRect& bounds) : m_name(name), m_bounds(bounds) {}
+    virtual ~ChartNode() = default;
+
+    ChartNode(const ChartNode&) = delete;
+    ChartNode& operator=(const ChartNode&) = delete;
+
+    ChartFrame frame;
+    std::function<QString()> title;             // 可空；每次重建时取一次
+
+    // 字符串字面量，同时用作绘制计时的阶段名
+    const char* name() const { return m_name; }
+    const QRect& bounds() const { return m_bounds; }
+
+    // 绘制范围超出 bounds 的像素数（如旋转的标签），标脏时一并重绘
+    void setOverhang(int pixels) { m_overhang = pixels; }
+    QRect paintRect() const { return m_bounds.adjusted(-m_overhang, -m_overhang, m_overhang, m_overhang); }
+
+    // 移动节点（如悬停提示框）：原位置和新位置都要重绘
+    void setBounds(const QRect& bounds) {
+        if (bounds == m_bounds) return;
+        if (m_visible) m_damage |= paintRect();
+        m_bounds = bounds;
+        invalidate();
+    }
+
+    // 数据变化：重建缓存并重绘整个节点
+    void invalidate() {
+        m_dirty = true;
+        m_damage |= paintRect();
+    }
+
+    // 数据变化但只有 part 里的像素会变：重建缓存，只重绘 part
+    void invalidate(const QRect& part) {
+        m_dirty = true;
+        m_damage |= part & paintRect();
+    }
+
+    // 隐藏的节点不重建、不绘制（如与其他节点轮流占用同一块区域）；切换时整块重绘
+    void setVisible(bool visible) {
+        if (visible == m_visible) return;
+        m_visible = visible;
+        invalidate();
+    }
+
+    bool isVisible() const { return m_visible; }
+
+    bool isDirty() const { return m_dirty; }
+    const QRect& damage() const { return m_damage; }
+
+    // 准备阶段（单线程）：脏时按绑定重建缓存
+    void sync() {
+        if (!m_dirty) return;
+        m_damage = QRect();
+        if (!m_visible) return;     // 保持脏标记，显示时再重建
+        m_title = title ? title() : QString();
+        rebuild();
+        m_dirty = false;
+    }
+
+    // 只读缓存；调用方已经设置好裁剪
+    virtual void paint(QPainter& p) const = 0;
+
+protected:
+    virtual void rebuild() = 0;
+
+    void paintFrame(QPainter& p) const { frame.paint(p, m_bounds, m_title); }
+
+private:
+    const char* m_name;
+    QRect m_bounds;
+    int m_overhang = 0;
+    bool m_visible = true;
+    bool m_dirty = true;
+    QRect m_damage;
+    QString m_title;
+};
+
+// 节点不归场景所有，由看板作为成员持有；按添加顺序绘制
+class ChartScene {
+public:
+    void add(ChartNode* node) {
+        m_nodes.push_back(node);
+        node->invalidate();
+    }
+
+    void invalidateAll() {
+        for (ChartNode* node : m_nodes) node->invalidate();
+    }
+
+    // 各节点待重绘区域之和，交给 QWidget::update()
+    QRegion dirtyRegion() const {
+        QRegion region;
+        for (const ChartNode* node : m_nodes)
+            if (node->isDirty()) region += node->damage();
+        return region;
+    }
+
+    void sync() {
+        for (ChartNode* node : m_nodes) node->sync();
+    }
+
+    // profiler 为空时不计时（分块线程里调用）
+    void paint(QPainter& p, const QRect& dirty, PaintProfiler* profiler) const {
+        for (const ChartNode* node : m_nodes) {
+            if (!node->isVisible() || !dirty.intersects(node->paintRect())) continue;
+            PAINT_SCOPE(profiler, node->name());
+            node->paint(p);
+        }
+    }
+
+private:
+    std::vector<ChartNode*> m_nodes;
+};
+
+// 单行文字（如底部总结）
+class LabelNode : public ChartNode {
+public:
+    using ChartNode::ChartNode;
+
+    std::function<QString()> text;
+    QColor color = Qt::white;
+    int fontSize = 10;
+    int fontWeight = QFont::Normal;
+    int flags = Qt::AlignLeft | Qt::AlignVCenter;
+
+    void paint(QPainter& p) const override {
+        if (m_text.isEmpty()) return;
+        p.setPen(color);
+        p.setFont(vizFont(fontSize, fontWeight));
+        drawCachedText(p, bounds(), flags, m_text);
+    }
+
+protected:
+    void rebuild() override { m_text = text ? text() : QString(); }
+
+private:
+    QString m_text;
+};
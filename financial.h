@@ -0,0 +1,798 @@
+#pragma once
+
+#include <QWidget>
+#include <QPainter>
+#include <QFont>
+#include <QVector>
+#include <QImage>
+#include <QEvent>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QWheelEvent>
+#include <QKeyEvent>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QScreen>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include "account_book.h"
+#include "bar_chart_node.h"
+#include "chart_scene.h"
+#include "hover_overlay.h"
+#include "ledger_feed.h"
+#include "ledger_loader.h"
+#include "paint_profiler.h"
+#include "pie_chart_node.h"
+#include "table_node.h"
+#include "tile_renderer.h"
+#include "viz_text_cache.h"
+
+// 财务看板：数据 + 绘制，不依赖 QWidget，可在工作线程里画到 QImage 上
+class FinanceDashboard {
+public:
+    FinanceDashboard() {
+        // 初始化数据 - 财务费用主要科目
+        initData();
+        setupScene();
+    }
+
+    void setSize(const QSize& size) {
+        if (size == m_size) return;
+        m_size = size;
+        m_staticDirty = true;
+    }
+
+    // 主题（调色板/样式/字体）变化时调用
+    void invalidateStaticLayer() { m_staticDirty = true; }
+
+    // 整体替换科目数据，未指定颜色的按调色板补齐
+    void setAccounts(QVector<AccountItem> items) {
+        for (int i = 0; i < items.size(); ++i)
+            if (!items[i].color.isValid()) items[i].color = paletteColor(i);
+        m_book.reset(items);
+        bookReset();
+    }
+
+    // 单个科目金额变化，O(log n) 维护合计与排名，只使受影响的图表节点失效
+    void setAccountAmount(const QString& name, Money amount) {
+        const quint64 version = m_book.version();
+        const int count = m_book.size();
+        const Money maxAmount = m_book.maxAmount();
+        if (count > 0) m_book.idAtRank(0);      // 先取排名快照，改完后据此判断名次是否变化
+
+        int id = m_book.setAmount(name, amount);
+        if (!m_book.at(id).color.isValid()) m_book.setColor(id, paletteColor(id));
+        if (m_book.version() == version) return;
+        clearHover();
+
+        // 合计变了，所有占比都跟着变：饼图、表格、总结整块重建
+        m_pie.invalidate();
+        m_table.invalidate();
+        m_summary.invalidate();
+
+        // 柱高只取决于金额 / 最大值：科目数、最大值、名次都没变时只有这一根柱子要重画
+        bool sameLayout = m_book.size() == count && m_book.maxAmount() == maxAmount && !m_book.rankStale();
+        if (sameLayout && count <= m_bars.capacity()) {
+            for (int rank = 0; rank < count; ++rank)
+                if (m_book.idAtRank(rank) == id) m_bars.invalidateBar(rank);
+        } else {
+            m_bars.invalidate();
+        }
+    }
+
+    // 实时流水：取出队列里的全部事件，按科目合并后一次并入金额。
+    // 每帧最多调用一次，返回本次合并的事件数
+    int applyFeed(LedgerFeed& feed) {
+        PAINT_SCOPE(m_profiler, "applyFeed");
+        if (feed.session() != m_feedSession) {
+            m_feedSession = feed.session();
+            m_feedAccounts.clear();
+            m_feedTouched.clear();
+        }
+
+        const int events = feed.drain([this](LedgerEvent& e) {
+            if (e.account >= m_feedAccounts.size()) m_feedAccounts.resize(e.account + 1);
+            FeedAccount& a = m_feedAccounts[e.account];
+            if (!e.name.isNull()) a.name = std::move(e.name);
+            if (!a.touched) {
+                a.touched = true;
+                m_feedTouched.push_back(e.account);
+            }
+            a.delta += e.amount;
+        });
+
+        for (quint32 k : m_feedTouched) {
+            FeedAccount& a = m_feedAccounts[k];
+            if (a.id < 0) {
+                a.id = m_book.find(a.name);
+                if (a.id < 0) {
+                    a.id = m_book.setAmount(a.name, Money());
+                    m_book.setColor(a.id, paletteColor(a.id));
+                }
+            }
+            m_book.setAmount(a.id, m_book.amount(a.id) + a.delta);
+            a.delta = Money();
+            a.touched = false;
+        }
+
+        // 一帧里通常有很多科目同时变化，各节点整块重建
+        if (!m_feedTouched.empty()) {
+            clearHover();
+            m_scene.invalidateAll();
+        }
+        m_feedTouched.clear();
+        return events;
+    }
+
+    // 数据变化后待重绘的区域（各失效节点的范围），窗口据此局部 update()
+    QRegion dirtyRegion() const { return m_scene.dirtyRegion(); }
+
+    // 从总账文件（CSV 或 .glb 二进制）流式导入，按科目汇总后替换当前数据
+    bool loadLedger(const QString& path, int threads = QThread::idealThreadCount()) {
+        LedgerLoader loader(threads);
+        if (!loader.load(path)) {
+            qDebug() << "总账导入失败:" << path << loader.errorString();
+            return false;
+        }
+        loader.report(path);
+
+        QVector<AccountItem> items;
+        items.reserve(loader.totals().size());
+        for (auto it = loader.totals().cbegin(); it != loader.totals().cend(); ++it) {
+            items.append({it.key(), it.value(), "→", paletteColor(items.size())});
+        }
+        m_book.reset(items);
+        bookReset();
+        return true;
+    }
+
+    // 打开快照（内存映射，不解析），失败时保持原数据
+    bool openSnapshot(const QString& path) {
+        QElapsedTimer timer;
+        timer.start();
+        QString error;
+        if (!m_book.openSnapshot(path, &error)) {
+            qDebug() << "快照打开失败:" << path << error;
+            return false;
+        }
+        bookReset();
+        qDebug().noquote() << QString("总账快照: %1 个科目, 映射 %2 ms")
+                .arg(m_book.size()).arg(timer.nsecsElapsed() / 1e6, 0, 'f', 2);
+        return true;
+    }
+
+    // 当前数据写成快照，供下次启动直接映射
+    bool writeSnapshot(const QString& path) const {
+        QString error;
+        if (!m_book.writeSnapshot(path, &error)) {
+            qDebug() << "快照写入失败:" << path << error;
+            return false;
+        }
+        return true;
+    }
+
+    // 表格滚动 rows 行（正数向下），返回是否需要重绘（只有表体失效）
+    bool scrollTable(int rows) {
+        return m_table.scrollBy(qint64(rows) * m_table.viewport().rowHeight());
+    }
+
+    // 滚轮滚动表格：有像素增量（触控板、高精度滚轮）时按像素滚，否则按角度每格（120）3 行，
+    // 不足一格的小增量也按比例滚，不会被整除成 0。返回是否需要重绘（只有表体失效）
+    bool scrollTableByWheel(const QPoint& pixelDelta, const QPoint& angleDelta) {
+        const qint64 dy = !pixelDelta.isNull() ? -qint64(pixelDelta.y())
+                          : -qint64(angleDelta.y()) * 3 * m_table.viewport().rowHeight() / 120;
+        return m_table.scrollBy(dy);
+    }
+
+    // 鼠标悬停：依次问柱状图、环形图、明细表命中了哪一名，只查各节点重建时建好的索引，不碰绘制。
+    // 命中项变化时换高亮和提示框，返回是否需要重绘（只有这两个小节点失效）
+    bool hover(const QPoint& pos) {
+        const ChartNode* node = &m_bars;
+        ChartHit hit = m_bars.hitTest(pos);
+        if (!hit.isValid()) {
+            node = &m_pie;
+            hit = m_pie.hitTest(pos);
+        }
+        if (!hit.isValid()) {
+            node = &m_table;
+            hit = m_table.hitTest(pos);
+        }
+        if (!hit.isValid()) node = nullptr;
+        if (node == m_hoverNode && hit == m_hoverHit) return false;
+        m_hoverNode = node;
+        m_hoverHit = hit;
+
+        if (node == &m_bars && hit.last < m_book.size()) {
+            m_hover.show(m_bars.hitShape(hit), barTooltip(hit), pos, rect());
+        } else if (node == &m_pie && hit.first < m_book.size()) {
+            m_hover.show(m_pie.hitShape(hit), accountTooltip(hit.first), pos, rect());
+        } else if (node == &m_table && hit.first < m_book.size()) {
+            m_hover.show(m_table.hitShape(hit), accountTooltip(hit.first) + "\n" + generateAnalysis(hit.first),
+                         pos, rect());
+        } else {
+            m_hover.hide();
+        }
+        return true;
+    }
+
+    // 金额、名次变化后命中项和几何都可能变了：先撤掉提示，鼠标再动时按新布局重新命中
+    void clearHover() {
+        m_hoverNode = nullptr;
+        m_hoverHit = ChartHit();
+        m_hover.hide();
+    }
+
+    // tiles 非空时分块并行光栅化，否则在当前线程直接画。
+    // 分块时各节点在工作线程里画，不计时，HUD 和 trace 只有一项 "tiles"
+    void render(QPainter& p, const QRect& dirty, qreal dpr, TileRenderer* tiles = nullptr) {
+        m_profiler.beginFrame();
+
+        {
+            PAINT_SCOPE(m_profiler, "prepare");
+            prepare(dpr);
+        }
+
+        if (tiles) {
+            PAINT_SCOPE(m_profiler, "tiles");
+            tiles->render(p, dirty, dpr, [this](QPainter& tp, const QRect& part) { paint(tp, part, nullptr); });
+        } else {
+            paint(p, dirty, &m_profiler);
+        }
+
+        m_profiler.endFrame();
+        if (m_profiler.enabled()) m_profiler.drawHud(p, hudOrigin());
+    }
+
+    // 绘制前在本线程准备好所有惰性缓存，之后 paint() 只读，可被多个线程同时调用
+    void prepare(qreal dpr) {
+        // 1~3. 静态层（背景、网格、标题、图表边框）只在尺寸/主题变化时重绘
+        ensureStaticLayer(dpr);
+
+        // 4. 只重建数据变化过的图表节点（排名快照、分桶、路径都在这里生成）
+        m_scene.sync();
+    }
+
+    // profiler 为空时不计时（分块线程里调用）
+    void paint(QPainter& p, const QRect& dirty, PaintProfiler* profiler) const {
+        {
+            PAINT_SCOPE(profiler, "staticLayer");
+            qreal dpr = m_staticLayer.devicePixelRatio();
+            p.drawImage(QRectF(dirty), m_staticLayer,
+                        QRectF(QPointF(dirty.topLeft()) * dpr, QSizeF(dirty.size()) * dpr));
+        }
+
+        p.setRenderHint(QPainter::Antialiasing);
+
+        // 4. 按节点缓存绘制各个图表的数据层（只画与脏区相交的节点）
+        m_scene.paint(p, dirty, profiler);
+    }
+
+    PaintProfiler& profiler() { return m_profiler; }
+    static QPoint hudOrigin() { return QPoint(8, 8); }
+
+    // 布局区域
+    static QRect barChartArea() { return QRect(60, 100, 450, 320); }
+    static QRect pieChartArea() { return QRect(550, 100, 500, 320); }
+    static QRect tableArea()    { return QRect(60, 450, 990, 260); }
+    static QRect summaryArea()  { return QRect(60, 720, 990, 20); }
+
+private:
+    QSize m_size{1100, 750};
+    AccountBook m_book;
+    ChartScene m_scene;                  // 数据层：柱状图、饼图、明细表、总结
+    BarChartNode m_bars{"drawBarChart", barChartArea()};
+    PieChartNode m_pie{"drawPieChart", pieChartArea()};
+    TableNode m_table{"drawTable", tableArea(), 40};
+    LabelNode m_summary{"drawSummary", summaryArea()};
+    HoverOverlay m_hover;               // 悬停高亮 + 提示框，叠在最上层
+    const ChartNode* m_hoverNode = nullptr;     // 当前命中的节点和名次
+    ChartHit m_hoverHit;
+    // 实时流水按流水内科目序号合并，id 缓存账本里的科目编号
+    struct FeedAccount {
+        QString name;
+        int id = -1;
+        Money delta;            // 本帧累计
+        bool touched = false;
+    };
+    quint64 m_feedSession = 0;
+    std::vector<FeedAccount> m_feedAccounts;
+    std::vector<quint32> m_feedTouched;
+    QImage m_staticLayer;         // 离屏缓存的静态背景层
+    PaintProfiler m_profiler;     // 绘制阶段计时
+    bool m_staticDirty = true;
+
+    int width() const { return m_size.width(); }
+    int height() const { return m_size.height(); }
+    QRect rect() const { return QRect(QPoint(0, 0), m_size); }
+
+    // 账本整体替换：所有节点重建，实时流水缓存的科目编号作废（名称保留）
+    void bookReset() {
+        clearHover();
+        m_scene.invalidateAll();
+        for (FeedAccount& a : m_feedAccounts) a.id = -1;
+    }
+
+    void ensureStaticLayer(qreal dpr) {
+        // 跨屏拖动时DPR会变化，也需要重建
+        QSize pixelSize = (QSizeF(m_size) * dpr).toSize();
+        if (!m_staticDirty && m_staticLayer.size() == pixelSize
+                && m_staticLayer.devicePixelRatio() == dpr) {
+            return;
+        }
+
+        m_staticLayer = QImage(pixelSize, QImage::Format_ARGB32_Premultiplied);
+        m_staticLayer.setDevicePixelRatio(dpr);
+        m_staticLayer.fill(Qt::transparent);
+
+        QPainter p(&m_staticLayer);
+        p.setRenderHint(QPainter::Antialiasing);
+
+        // 1. 专业金融背景渐变
+        {
+            PAINT_SCOPE(m_profiler, "background");
+            drawGradientBackground(p);
+        }
+
+        // 2. 添加网格线
+        {
+            PAINT_SCOPE(m_profiler, "grid");
+            drawGrid(p);
+        }
+
+        // 3. 绘制标题和装饰
+        {
+            PAINT_SCOPE(m_profiler, "title");
+            drawTitle(p);
+        }
+
+        // 图表边框和标题
+        {
+            PAINT_SCOPE(m_profiler, "chartFrames");
+            drawChartBackground(p, barChartArea(), "📈 财务费用科目金额对比");
+            drawChartBackground(p, pieChartArea(), "📊 费用构成占比分析");
+            drawChartBackground(p, tableArea(), "📋 财务费用明细分析表");
+        }
+
+        m_staticDirty = false;
+    }
+
+    void initData() {
+        // 财务费用主要科目数据（单位：万元）
+        m_book.reset({
+                {"利息支出", Money::fromWan(115.6), "↑", QColor(231, 76, 60)},     // 红色
+                {"汇兑损失", Money::fromWan(82.3), "↑", QColor(230, 126, 34)},    // 橙色
+                {"手续费", Money::fromWan(45.8), "→", QColor(241, 196, 15)},      // 黄色
+                {"现金折扣", Money::fromWan(28.4), "↓", QColor(46, 204, 113)},    // 绿色
+                {"其他财务费用", Money::fromWan(15.2), "→", QColor(52, 152, 219)} // 蓝色
+        });
+    }
+
+    // 数据层各节点的样式和数据绑定；边框和标题在静态层里，节点不画
+    void setupScene() {
+        // 柱状图：按金额降序，放得下时逐项画（带3D渐变、高光、金额、名称、趋势），否则分桶
+        BarChartNode::Style& bar = m_bars.style;
+        bar.barWidth = 50;
+        bar.spacing = 30;
+        bar.rightInset = 20;
+        bar.heightInset = 65;
+        bar.valueGap = 25;
+        bar.valueHeight = 20;
+        bar.valueWiden = 10;
+        bar.rotatedLabels = false;
+        bar.tickLength = 8;
+        bar.tickLabelGap = 2;
+        bar.tickLabelWidth = 45;
+        bar.tickDecimals = 0;
+        bar.tickColor = QColor(200, 200, 255, 180);
+        bar.axisColor = QColor(255, 255, 255, 120);
+        bar.lodCaption = "共 %1 个科目，每列约 %2 项";
+        m_bars.count = [this] { return m_book.size(); };
+        m_bars.value = [this](int rank) { return m_book.amount(m_book.idAtRank(rank)).toWan(); };
+        m_bars.bandColors = [](int) {
+            return BarChartNode::BandColors{QColor(52, 152, 219).lighter(140), QColor(52, 152, 219, 120),
+                                            QColor(41, 128, 185)};
+        };
+        m_bars.bar = [this](int rank) {
+            const AccountItem item = m_book.at(m_book.idAtRank(rank));
+            BarChartNode::Bar b;
+            b.value = item.amount.toWan();
+            b.stops = {{0.0, item.color.lighter(130)},     // 顶部亮
+                       {0.7, item.color},                  // 中部原色
+                       {1.0, item.color.darker(130)}};     // 底部暗
+            b.highlight = item.color.lighter(180);
+            b.valueText = item.amount.toWanString(1) + "万";
+            b.label = item.name;
+            b.badge = item.trend;
+            b.badgeColor = trendColor(item.trend, Qt::white);
+            return b;
+        };
+
+        // 环形图：扇形锥形渐变，图例只列放得下的前几项
+        PieChartNode::Style& pie = m_pie.style;
+        pie.centerX = 140;
+        pie.radius = 100;
+        pie.shadowOffset = 5;
+        pie.shadowAlpha = 80;
+        pie.gradientSlices = true;
+        pie.sorted = true;
+        pie.labelMinSpan = 20;
+        pie.labelRadius = 0.65;
+        pie.labelWidth = 50;
+        pie.labelDecimals = 1;
+        pie.holeRatio = 0.5;
+        pie.holeColor = QColor(13, 27, 42);
+        pie.centerText = "构成比";
+        pie.legendOffset = QPoint(280, 60);
+        pie.legendTextOffset = 25;
+        pie.legendTextWidth = 180;
+        pie.legendBadgeOffset = 190;
+        pie.legendTextColor = QColor(240, 240, 255);
+        pie.swatchPen = QColor(255, 255, 255, 100);
+        m_pie.count = [this] { return m_book.size(); };
+        m_pie.slice = [this](int rank) {
+            const int id = m_book.idAtRank(rank);
+            return PieChartNode::Slice{m_book.ratio(id) / 100, m_book.at(id).color};
+        };
+        m_pie.legendRow = [this](int rank) {
+            const int id = m_book.idAtRank(rank);
+            const AccountItem item = m_book.at(id);
+            return PieChartNode::LegendRow{item.color,
+                                           QString("%1 %2% (%3万)")
+                                                   .arg(item.name)
+                                                   .arg(m_book.ratio(id), 0, 'f', 1)
+                                                   .arg(item.amount.toWanString(1)),
+                                           item.trend, trendColor(item.trend, QColor(46, 204, 113))};
+        };
+
+        // 明细表：表头渐变，金额按大小着色，只格式化可见行
+        TableNode::Style& table = m_table.style;
+        table.headerTop = 20;
+        table.headerColor = QColor(52, 152, 219, 200);
+        table.headerColor2 = QColor(41, 128, 185, 200);
+        table.headerTextColor = QColor(255, 255, 255);
+        table.headerFontSize = 12;
+        table.evenRow = QColor(255, 255, 255, 20);
+        table.oddRow = QColor(255, 255, 255, 8);
+        m_table.columns = {
+                {"序号", 60, Qt::AlignCenter},
+                {"会计科目", 250, Qt::AlignLeft | Qt::AlignVCenter},
+                {"金额(万元)", 120, Qt::AlignRight | Qt::AlignVCenter},
+                {"占比(%)", 100, Qt::AlignCenter},
+                {"趋势", 80, Qt::AlignCenter},
+                {"分析说明", 400, Qt::AlignLeft | Qt::AlignVCenter}
+        };
+        m_table.rowCount = [this] { return qint64(m_book.size()); };
+        m_table.cells = [this](qint64 row, std::vector<TableNode::Cell>& cells) {
+            const int i = int(row);
+            const int id = m_book.idAtRank(i);
+            const AccountItem item = m_book.at(id);
+            cells = {
+                    {QString::number(i + 1), QColor(200, 220, 255), Qt::AlignCenter},
+                    {item.name, Qt::white},
+                    {item.amount.toWanString(1), amountColor(item.amount), Qt::AlignRight | Qt::AlignVCenter},
+                    {QString::number(m_book.ratio(id), 'f', 1) + "%", QColor(174, 214, 241), Qt::AlignCenter},
+                    {item.trend, trendColor(item.trend, QColor(46, 204, 113)), Qt::AlignCenter, 12, QFont::Bold},
+                    {generateAnalysis(i), QColor(220, 220, 220), Qt::AlignLeft | Qt::AlignVCenter, 9}
+            };
+        };
+
+        // 底部总结：合计由 AccountBook 按分增量维护
+        m_summary.color = QColor(255, 255, 255, 180);
+        m_summary.fontWeight = QFont::Bold;
+        m_summary.text = [this] {
+            if (m_book.empty()) return QString();
+            return QString("📊 分析总结: 本期财务费用总额 %1 万元，其中%2占比最高，建议优化融资结构。")
+                    .arg(m_book.total().toWanString(1))
+                    .arg(m_book.at(m_book.idAtRank(0)).name);
+        };
+
+        m_scene.add(&m_bars);
+        m_scene.add(&m_pie);
+        m_scene.add(&m_table);
+        m_scene.add(&m_summary);
+        m_hover.addTo(m_scene);
+    }
+
+    // 第 rank 名科目的完整信息（柱下名称、图例、表格列宽都会截断）；名称放最后替换，不会被当成占位符
+    QString accountTooltip(int rank) const {
+        const int id = m_book.idAtRank(rank);
+        const AccountItem item = m_book.at(id);
+        return QString("%5\n金额: %1 元（%2 万元）\n占比: %3%  趋势: %4")
+                .arg(item.amount.toYuanString(), item.amount.toWanString(2))
+                .arg(m_book.ratio(id), 0, 'f', 2)
+                .arg(item.trend)
+                .arg(item.name);
+    }
+
+    // 柱状图命中一根柱子时同上；LOD 时为一个桶：名次范围、金额范围和桶内金额最大的科目
+    QString barTooltip(const ChartHit& hit) const {
+        if (hit.first == hit.last) return accountTooltip(hit.first);
+        return QString("第 %1 ~ %2 名（共 %3 个科目）\n金额: %4 ~ %5 万元\n最高: %6")
+                .arg(hit.first + 1).arg(hit.last + 1).arg(m_book.size())
+                .arg(m_book.amount(m_book.idAtRank(hit.last)).toWanString(1),
+                     m_book.amount(m_book.idAtRank(hit.first)).toWanString(1))
+                .arg(m_book.at(m_book.idAtRank(hit.first)).name);
+    }
+
+    // 趋势颜色：↑ 红 ↓ 绿，其余为 flat
+    static QColor trendColor(const QString& trend, const QColor& flat) {
+        if (trend == "↑") return QColor(231, 76, 60);
+        if (trend == "↓") return QColor(46, 204, 113);
+        return flat;
+    }
+
+    // 金额颜色：>100万 红，>50万 橙，其余绿
+    static QColor amountColor(Money amount) {
+        if (amount > Money::fromWan(100)) return QColor(231, 76, 60);
+        if (amount > Money::fromWan(50)) return QColor(230, 126, 34);
+        return QColor(46, 204, 113);
+    }
+
+    static QColor paletteColor(int index) {
+        static const QColor palette[] = {
+                QColor(231, 76, 60), QColor(230, 126, 34), QColor(241, 196, 15),
+                QColor(46, 204, 113), QColor(52, 152, 219), QColor(155, 89, 182),
+                QColor(26, 188, 156), QColor(236, 112, 99)
+        };
+        return palette[index % (sizeof(palette) / sizeof(palette[0]))];
+    }
+
+    void drawGradientBackground(QPainter& p) {
+        // 深蓝色渐变背景，金融风格
+        QLinearGradient gradient(0, 0, width(), height());
+        gradient.setColorAt(0.0, QColor(13, 27, 42));    // 深蓝黑
+        gradient.setColorAt(0.5, QColor(22, 44, 69));    // 金融蓝
+        gradient.setColorAt(1.0, QColor(31, 58, 88));    // 稍浅蓝
+
+        p.fillRect(rect(), gradient);
+
+        // 添加微弱的网格纹理
+        p.setPen(QColor(255, 255, 255, 8));
+        for (int x = 0; x < width(); x += 20) {
+            p.drawLine(x, 0, x, height());
+        }
+        for (int y = 0; y < height(); y += 20) {
+            p.drawLine(0, y, width(), y);
+        }
+    }
+
+    void drawGrid(QPainter& p) {
+        p.setPen(QColor(255, 255, 255, 15));
+
+        // 主要网格线
+        for (int x = 50; x < width(); x += 100) {
+            p.drawLine(x, 0, x, height());
+        }
+        for (int y = 50; y < height(); y += 50) {
+            p.drawLine(0, y, width(), y);
+        }
+    }
+
+    void drawTitle(QPainter& p) {
+        // 主标题
+        QLinearGradient titleGrad(0, 0, width(), 0);
+        titleGrad.setColorAt(0.0, QColor(64, 224, 208));   // 青色
+        titleGrad.setColorAt(0.5, QColor(138, 43, 226));   // 紫色
+        titleGrad.setColorAt(1.0, QColor(255, 105, 180));  // 粉色
+
+        p.setFont(vizFont(24, QFont::Bold));
+        p.setPen(QPen(titleGrad, 2));
+        p.drawText(0, 0, width(), 70, Qt::AlignCenter,
+                   "💰 财务会计科目对比分析");
+
+        // 副标题
+        p.setFont(vizFont(12));
+        p.setPen(QColor(200, 220, 255, 200));
+        p.drawText(0, 45, width(), 30, Qt::AlignCenter,
+                   "财务费用构成分析 | 数据期间: 2025年9-12月 | 单位: 万元");
+
+        // 装饰线
+        p.setPen(QPen(QColor(100, 150, 255, 80), 1));
+        p.drawLine(100, 65, width() - 100, 65);
+        p.drawLine(100, 67, width() - 100, 67);
+    }
+
+    static QString generateAnalysis(int index) {
+        switch(index) {
+            case 0: return "主要融资成本，受利率政策影响";
+            case 1: return "汇率波动导致，需加强外汇风险管理";
+            case 2: return "银行手续费等，相对稳定";
+            case 3: return "供应商现金折扣，有所减少";
+            case 4: return "其他零星费用，占比最小";
+            default: return "正常业务发生";
+        }
+    }
+
+    void drawChartBackground(QPainter& p, const QRect& area, const QString& title) {
+        // 1. 外阴影（向右下偏移）
+        p.setPen(Qt::NoPen);
+        p.setBrush(QColor(0, 0, 0, 25));
+        p.drawRoundedRect(area.translated(2, 2), 12, 12);
+
+        // 2. 主背景
+        QLinearGradient bgGrad(area.topLeft(), area.bottomRight());
+        bgGrad.setColorAt(0.0, QColor(255, 255, 255, 10));
+        bgGrad.setColorAt(1.0, QColor(255, 255, 255, 25));
+        p.setBrush(bgGrad);
+        p.setPen(QPen(QColor(100, 150, 255, 80), 1.5));
+        p.drawRoundedRect(area, 12, 12);
+
+        // 3. 内边框（高光效果）
+        p.setPen(QPen(QColor(255, 255, 255, 40), 1));
+        p.setBrush(Qt::NoBrush);
+        p.drawRoundedRect(area.adjusted(1, 1, -1, -1), 11, 11);
+
+        // 标题
+        p.setPen(QColor(220, 240, 255));
+        p.setFont(vizFont(13, QFont::Bold));
+        p.drawText(area.left(), area.top() - 5, area.width(), 30,
+                   Qt::AlignCenter, title);
+    }
+};
+
+class FinanceAnalysisViz : public QWidget {
+public:
+    FinanceAnalysisViz(QWidget* parent = nullptr) : QWidget(parent) {
+        setWindowTitle("(C++QT版)财务会计科目可视化分析图表(作者-冷溪虎山)");
+        resize(1100, 750);
+        setFocusPolicy(Qt::StrongFocus);
+        setMouseTracking(true);     // 不按键也收 mouseMoveEvent，用于悬停提示
+
+        m_feedTimer.setSingleShot(true);
+        m_feedTimer.setTimerType(Qt::PreciseTimer);
+        connect(&m_feedTimer, &QTimer::timeout, this, [this] { applyFeedFrame(); });
+        m_feedClock.start();
+    }
+
+    ~FinanceAnalysisViz() override { stopLiveFeed(); }
+
+    FinanceDashboard& dashboard() { return m_dash; }
+
+    void setAccountAmount(const QString& name, Money amount) {
+        // 只重绘失效节点的区域（通常是一根柱子 + 饼图、表格、总结）
+        m_dash.setAccountAmount(name, amount);
+        damage(m_dash.dirtyRegion());
+    }
+
+    bool loadLedger(const QString& path, int threads = QThread::idealThreadCount()) {
+        bool ok = m_dash.loadLedger(path, threads);
+        update();
+        return ok;
+    }
+
+    bool openSnapshot(const QString& path) {
+        bool ok = m_dash.openSnapshot(path);
+        update();
+        return ok;
+    }
+
+    // 实时流水模式：source 为本地套接字名称/路径（Windows 上即命名管道），"-" 为标准输入管道
+    bool startLiveFeed(const QString& source) {
+        stopLiveFeed();
+        m_feed.reset(new LedgerFeed);
+        // 在读线程里调用：只投递一条消息，合并留到下一帧
+        bool ok = m_feed->start(source, [this] {
+            QMetaObject::invokeMethod(this, [this] { scheduleFeedFrame(); }, Qt::QueuedConnection);
+        });
+        if (!ok) m_feed.reset();
+        return ok;
+    }
+
+    void stopLiveFeed() {
+        m_feedTimer.stop();
+        m_feed.reset();     // 析构时等读线程退出
+    }
+
+    // 分块并行绘制线程数，1 表示在 GUI 线程直接画（默认）。
+    // 分块只对整窗 4K 重绘划算，提示框、单根柱子这类小脏区分块反而要等线程池
+    void setPaintThreads(int threads) {
+        m_tiles.setThreadCount(threads);
+        m_tiled = threads > 1;
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent* e) override {
+        QPainter p(this);
+        m_dash.render(p, e->rect(), devicePixelRatioF(), m_tiled ? &m_tiles : nullptr);
+    }
+
+    void wheelEvent(QWheelEvent* e) override {
+        // 表格区域内滚轮滚动（每格3行，触控板按像素）；鼠标下换了一行，提示跟着换
+        const QPoint pos = e->position().toPoint();
+        if (FinanceDashboard::tableArea().contains(pos)) {
+            if (m_dash.scrollTableByWheel(e->pixelDelta(), e->angleDelta())) {
+                m_dash.hover(pos);
+                damage(m_dash.dirtyRegion());
+            }
+            e->accept();
+            return;
+        }
+        QWidget::wheelEvent(e);
+    }
+
+    void mouseMoveEvent(QMouseEvent* e) override {
+        if (m_dash.hover(e->pos())) damage(m_dash.dirtyRegion());
+    }
+
+    void leaveEvent(QEvent* e) override {
+        m_dash.clearHover();
+        damage(m_dash.dirtyRegion());
+        QWidget::leaveEvent(e);
+    }
+
+    void keyPressEvent(QKeyEvent* e) override {
+        switch (e->key()) {
+            case Qt::Key_F12:   // 开关绘制计时 HUD
+                m_dash.profiler().setEnabled(!m_dash.profiler().enabled());
+                m_dash.profiler().clear();
+                update();
+                break;
+            case Qt::Key_F10:   // 切换分块并行/单线程绘制，便于对比
+                m_tiled = !m_tiled;
+                m_dash.profiler().clear();
+                qDebug() << "分块并行绘制:" << m_tiled << "线程数:" << m_tiles.threadCount();
+                update();
+                break;
+            case Qt::Key_F11: { // 导出 Chrome trace
+                QString path = QString("paint_trace_%1.json")
+                        .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+                qDebug() << "导出绘制trace:" << path << m_dash.profiler().exportChromeTrace(path);
+                break;
+            }
+            default:
+                QWidget::keyPressEvent(e);
+        }
+    }
+
+    void resizeEvent(QResizeEvent* e) override {
+        m_dash.setSize(size());
+        QWidget::resizeEvent(e);
+    }
+
+    void changeEvent(QEvent* e) override {
+        // 主题（调色板/样式/字体）变化时重建静态层
+        switch (e->type()) {
+            case QEvent::PaletteChange:
+            case QEvent::StyleChange:
+            case QEvent::FontChange:
+                m_dash.invalidateStaticLayer();
+                update();
+                break;
+            default:
+                break;
+        }
+        QWidget::changeEvent(e);
+    }
+
+private:
+    FinanceDashboard m_dash;
+    TileRenderer m_tiles;       // 分块并行光栅化
+    bool m_tiled = false;       // --paint-threads N>1 或 F10 打开
+    std::unique_ptr<LedgerFeed> m_feed;
+    QTimer m_feedTimer;         // 按显示帧合并流水
+    QElapsedTimer m_feedClock;
+    qint64 m_lastFeedFrameNs = 0;
+
+    // 距上次合并不足一帧时等到下一帧；计时器已在等待时，本帧内的通知都并进这一次
+    void scheduleFeedFrame() {
+        if (!m_feed || m_feedTimer.isActive()) return;
+        const qreal hz = screen() && screen()->refreshRate() > 0 ? screen()->refreshRate() : 60;
+        const double waitMs = 1000.0 / hz - (m_feedClock.nsecsElapsed() - m_lastFeedFrameNs) / 1e6;
+        m_feedTimer.start(qMax(0, int(std::ceil(waitMs))));
+    }
+
+    void applyFeedFrame() {
+        if (!m_feed) return;
+        m_lastFeedFrameNs = m_feedClock.nsecsElapsed();
+        if (m_dash.applyFeed(*m_feed) > 0) damage(m_dash.dirtyRegion());
+    }
+
+    // 局部重绘；HUD 打开时顺带刷新 HUD 区域
+    void damage(QRegion region) {
+        if (m_dash.profiler().enabled()) region += PaintProfiler::hudRect(FinanceDashboard::hudOrigin());
+        update(region);
+    }
+};
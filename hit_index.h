@@ -0,0 +1,66 @@
+#pragma once
+
+// 鼠标命中索引
+//
+// 图表节点重建缓存时，把各项在某一维上占的区间（柱子/分桶列的 x 范围、扇形的角度范围）按起点
+// 顺序登记下来。鼠标移动时在起点列上二分，O(log n) 找到所在区间，只读这几个数组，不碰画刷、
+// 路径和文字。布局里相邻项并排摆放、区间互不重叠，有序数组二分就够用，不需要一般的区间树；
+// 落在间隙（柱间距）里的点不命中。
+
+#include <QtGlobal>
+#include <algorithm>
+#include <vector>
+
+// 节点命中结果：命中的数据项 [first, last]（通常 first == last，柱状图 LOD 时为一个桶），
+// slot 为节点内部的缓存位置，取高亮形状时原样传回
+struct ChartHit {
+    int first = -1;
+    int last = -1;
+    int slot = -1;
+
+    bool isValid() const { return slot >= 0; }
+
+    friend bool operator==(const ChartHit& a, const ChartHit& b) {
+        return a.slot == b.slot && a.first == b.first && a.last == b.last;
+    }
+    friend bool operator!=(const ChartHit& a, const ChartHit& b) { return !(a == b); }
+};
+
+class SpanIndex {
+public:
+    void clear() {
+        m_starts.clear();
+        m_ends.clear();
+        m_ids.clear();
+    }
+
+    void reserve(int n) {
+        m_starts.reserve(size_t(n));
+        m_ends.reserve(size_t(n));
+        m_ids.reserve(size_t(n));
+    }
+
+    int size() const { return int(m_starts.size()); }
+
+    // 区间 [start, end) 属于 id；须按 start 递增登记，且不与前一个区间重叠
+    void add(double start, double end, int id) {
+        Q_ASSERT(m_ends.empty() || start >= m_ends.back());
+        if (end <= start) return;       // 空区间不登记
+        m_starts.push_back(start);
+        m_ends.push_back(end);
+        m_ids.push_back(id);
+    }
+
+    // 包含 x 的区间的 id，没有返回 -1
+    int find(double x) const {
+        auto it = std::upper_bound(m_starts.begin(), m_starts.end(), x);
+        if (it == m_starts.begin()) return -1;
+        const size_t i = size_t(it - m_starts.begin()) - 1;
+        return x < m_ends[i] ? m_ids[i] : -1;
+    }
+
+private:
+    std::vector<double> m_starts;       // 起点单独一列，二分时只扫这一列
+    std::vector<double> m_ends;
+    std::vector<int> m_ids;
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+// 悬停高亮与提示框
+//
+// 两个小节点最后加入场景，叠在图表之上：高亮描出命中项的轮廓，提示框显示完整名称和明细
+// （坐标轴、图例、表格里放不下的名称会截断）。悬停项变化时只移动、重建这两个节点，
+// 待重绘区域就是它们新旧位置的范围，底下的节点不失效，按缓存重画。
+// 提示框尺寸在显示时按字体量好，paint() 只画缓存的框和文字。
+
+#include <QFontMetrics>
+#include <QPainterPath>
+#include "chart_scene.h"
+
+// 命中项轮廓；形状由节点按缓存几何给出
+class HighlightNode : public ChartNode {
+public:
+    QColor fill = QColor(255, 255, 255, 45);
+    QColor pen = QColor(255, 255, 255, 220);
+
+    explicit HighlightNode(const char* name) : ChartNode(name, QRect()) { setVisible(false); }
+
+    void setShape(const QPainterPath& shape) {
+        m_shape = shape;
+        setBounds(shape.boundingRect().toAlignedRect().adjusted(-2, -2, 2, 2));    // 含描边
+        invalidate();
+    }
+
+    void paint(QPainter& p) const override {
+        p.setBrush(fill);
+        p.setPen(vizPen(pen, 1.5));
+        p.drawPath(m_shape);
+    }
+
+protected:
+    // QPainterPath 的包围盒是惰性计算的，这里先算好，paint() 只读
+    void rebuild() override {
+        m_shape.controlPointRect();
+        m_shape.boundingRect();
+    }
+
+private:
+    QPainterPath m_shape;
+};
+
+// 多行提示框，放在鼠标右下方，超出 limits 时翻到左/上侧
+class TooltipNode : public ChartNode {
+public:
+    struct Style {
+        int fontSize = 9;
+        int maxTextWidth = 320;     // 超过时折行
+        int padding = 8;
+        QPoint cursorOffset = QPoint(14, 18);
+        QColor fill = QColor(15, 22, 45, 235);
+        QColor border = QColor(100, 180, 255, 180);
+        QColor textColor = QColor(230, 240, 255);
+    };
+
+    Style style;
+
+    explicit TooltipNode(const char* name) : ChartNode(name, QRect()) { setVisible(false); }
+
+    void setText(const QString& text, const QPoint& cursor, const QRect& limits) {
+        const QFontMetrics metrics(vizFont(style.fontSize));
+        const int flags = Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap;
+        const QSize textSize = metrics.boundingRect(QRect(0, 0, style.maxTextWidth, 10000), flags, text).size();
+        QRect box(QPoint(), textSize + QSize(2 * style.padding, 2 * style.padding));
+
+        box.moveTopLeft(cursor + style.cursorOffset);
+        if (box.right() > limits.right()) box.moveRight(cursor.x() - style.cursorOffset.x());
+        if (box.bottom() > limits.bottom()) box.moveBottom(cursor.y() - style.cursorOffset.y());
+        box.moveLeft(qMax(box.left(), limits.left()));
+        box.moveTop(qMax(box.top(), limits.top()));
+
+        m_text = text;
+        m_textWidth = textSize.width();
+        setBounds(box);
+        invalidate();
+    }
+
+    void paint(QPainter& p) const override {
+        const QRect& box = bounds();
+        p.setBrush(style.fill);
+        p.setPen(style.border);
+        p.drawRoundedRect(QRectF(box).adjusted(0.5, 0.5, -0.5, -0.5), 5, 5);
+
+        p.setPen(style.textColor);
+        p.setFont(vizFont(style.fontSize));
+        drawCachedText(p, box.left() + style.padding, box.top() + style.padding, m_textWidth,
+                       box.height() - 2 * style.padding, Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap, m_text);
+    }
+
+protected:
+    void rebuild() override {}
+
+private:
+    QString m_text;
+    int m_textWidth = 0;
+};
+
+// 一组高亮 + 提示框；看板作为成员持有，setupScene() 最后加入场景
+class HoverOverlay {
+public:
+    void addTo(ChartScene& scene) {
+        scene.add(&m_highlight);
+        scene.add(&m_tooltip);
+    }
+
+    bool isVisible() const { return m_tooltip.isVisible(); }
+
+    // cursor 为鼠标位置，提示框限制在 limits（窗口）内
+    void show(const QPainterPath& shape, const QString& text, const QPoint& cursor, const QRect& limits) {
+        m_highlight.setShape(shape);
+        m_highlight.setVisible(true);
+        m_tooltip.setText(text, cursor, limits);
+        m_tooltip.setVisible(true);
+    }
+
+    void hide() {
+        m_highlight.setVisible(false);
+        m_tooltip.setVisible(false);
+    }
+
+private:
+    HighlightNode m_highlight{"drawHighlight"};
+    TooltipNode m_tooltip{"drawTooltip"};
+};
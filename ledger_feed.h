@@ -0,0 +1,237 @@
+#pragma once
+
+// 实时总账流水
+//
+// 专用读线程从本地套接字（Windows 上即命名管道）或标准输入管道读取 "科目,金额(元)" 文本行，
+// 解析后经单生产者单消费者无锁队列（SpscRing）交给 GUI 线程。读线程给每个科目分配流水内序号，
+// 只在科目第一次出现时附带名称，之后的事件只有 {序号, 金额}。
+//
+// 队列由空变非空时只通知一次（notify 在读线程里调用，只应投递消息），GUI 线程在下一帧
+// drain() 全部取出合并，所以无论每秒到达多少事件，每个显示帧最多合并、重绘一次。
+// 队列满时读线程等待而不丢事件，反压沿管道/套接字传回发送端。
+
+#include <QByteArray>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QLocalSocket>
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include "ledger_loader.h"
+#include "spsc_ring.h"
+
+#if defined(Q_OS_UNIX)
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+struct LedgerEvent {
+    quint32 account = 0;    // 流水内科目序号，从 0 开始连续分配
+    Money amount;
+    QString name;           // 只在该科目第一次出现时非空
+};
+
+class LedgerFeed {
+public:
+    struct Stats {
+        qint64 events = 0;
+        qint64 skipped = 0;     // 无法解析的行
+        qint64 bytes = 0;
+        qint64 stalls = 0;      // 队列满、读线程等待的次数
+    };
+
+    explicit LedgerFeed(int capacity = 1 << 16) : m_ring(size_t(capacity)), m_session(nextSession()) {}
+    ~LedgerFeed() { stop(); }
+
+    LedgerFeed(const LedgerFeed&) = delete;
+    LedgerFeed& operator=(const LedgerFeed&) = delete;
+
+    // source 为本地套接字名称/路径，"-" 为标准输入（仅 Unix）；连上后才返回 true
+    bool start(const QString& source, std::function<void()> notify) {
+        stop();
+        m_ring.popAll([](LedgerEvent&) {});     // 上一次会话没取走的事件作废
+        m_accounts.clear();
+        m_carry.clear();
+        m_session = nextSession();
+        m_source = source;
+        m_notify = std::move(notify);
+        m_stop = false;
+        m_events = m_skipped = m_bytes = m_stalls = 0;
+        m_clock.start();
+
+        std::promise<bool> opened;
+        std::future<bool> result = opened.get_future();
+        m_thread = std::thread([this, p = std::move(opened)]() mutable { run(p); });
+        if (result.get()) return true;
+        m_thread.join();
+        return false;
+    }
+
+    // 停止并等待读线程退出，输出统计
+    void stop() {
+        if (!m_thread.joinable()) return;
+        m_stop = true;
+        m_thread.join();
+        const Stats s = stats();
+        const double sec = m_clock.nsecsElapsed() / 1e9;
+        qDebug().noquote() << QString("实时流水 %1: %2 条事件 (%3 条/秒), 跳过 %4 行, 队列满等待 %5 次")
+                .arg(m_source).arg(s.events).arg(sec > 0 ? s.events / sec : 0, 0, 'f', 0)
+                .arg(s.skipped).arg(s.stalls);
+    }
+
+    // 每次 start() 换一个会话号；会话变了，之前的科目序号全部作废
+    quint64 session() const { return m_session; }
+
+    // GUI 线程：取出队列里已有的全部事件，对每个调用 f(LedgerEvent&)，返回个数
+    template <typename F>
+    int drain(F f) {
+        // 先清通知标记再取：取的过程中新到的事件会再通知一次，不会漏
+        m_notified.store(false);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return int(m_ring.popAll(f));
+    }
+
+    // 解析一块文本并入队，不完整的行留到下一块。读线程内部调用；
+    // 没有 start() 时也可以由调用方单线程直接喂数据（基准测试），但一次不能超过队列容量
+    void ingest(const char* data, qint64 size) {
+        m_carry.append(data, int(size));
+        m_bytes.fetch_add(size, std::memory_order_relaxed);
+
+        const char* begin = m_carry.constData();
+        const char* end = begin + m_carry.size();
+        const char* p = begin;
+        qint64 events = 0;
+        qint64 skipped = 0;
+        while (const char* eol = static_cast<const char*>(memchr(p, '\n', end - p))) {
+            const char* name = nullptr;
+            int nameLen = 0;
+            Money amount;
+            if (LedgerLoader::parseCsvLine(p, eol, name, nameLen, amount)) {
+                push(name, nameLen, amount);
+                ++events;
+            } else if (eol - p > 1) {
+                ++skipped;      // 表头或坏行
+            }
+            p = eol + 1;
+        }
+        m_carry.remove(0, int(p - begin));
+
+        m_events.fetch_add(events, std::memory_order_relaxed);
+        m_skipped.fetch_add(skipped, std::memory_order_relaxed);
+        if (events > 0) signal();
+    }
+
+    Stats stats() const {
+        Stats s;
+        s.events = m_events.load(std::memory_order_relaxed);
+        s.skipped = m_skipped.load(std::memory_order_relaxed);
+        s.bytes = m_bytes.load(std::memory_order_relaxed);
+        s.stalls = m_stalls.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    static constexpr qint64 kReadSize = 64 * 1024;
+    static constexpr int kPollMs = 100;     // 读线程检查停止标记的间隔
+
+    SpscRing<LedgerEvent> m_ring;
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_notified{false};
+    std::function<void()> m_notify;
+    QString m_source;
+    quint64 m_session;
+    QElapsedTimer m_clock;
+
+    // 以下只在读线程里访问
+    QHash<QByteArray, quint32> m_accounts;  // 科目名 -> 流水内序号
+    QByteArray m_carry;                     // 上一块末尾不完整的行
+
+    std::atomic<qint64> m_events{0};
+    std::atomic<qint64> m_skipped{0};
+    std::atomic<qint64> m_bytes{0};
+    std::atomic<qint64> m_stalls{0};
+
+    static quint64 nextSession() {
+        static std::atomic<quint64> counter{0};
+        return ++counter;
+    }
+
+    void run(std::promise<bool>& opened) {
+        std::unique_ptr<QLocalSocket> socket;
+        if (m_source == "-") {
+#if !defined(Q_OS_UNIX)
+            qDebug() << "标准输入流水只在 Unix 上支持，请改用本地套接字（命名管道）";
+            opened.set_value(false);
+            return;
+#endif
+        } else {
+            // 套接字在读线程里创建，阻塞等待，不需要事件循环
+            socket.reset(new QLocalSocket);
+            socket->connectToServer(m_source, QIODevice::ReadOnly);
+            if (!socket->waitForConnected(2000)) {
+                qDebug() << "实时流水连接失败:" << m_source << socket->errorString();
+                opened.set_value(false);
+                return;
+            }
+        }
+        opened.set_value(true);
+
+        QByteArray chunk(int(kReadSize), Qt::Uninitialized);
+        while (!m_stop.load(std::memory_order_relaxed)) {
+            qint64 n = 0;
+            if (socket) {
+                if (socket->bytesAvailable() == 0 && !socket->waitForReadyRead(kPollMs)) {
+                    if (socket->state() != QLocalSocket::ConnectedState) break;    // 发送端关闭
+                    continue;
+                }
+                n = socket->read(chunk.data(), kReadSize);
+            } else {
+#if defined(Q_OS_UNIX)
+                // QFile 读管道会等到读满才返回，这里直接 poll + read
+                pollfd pfd{STDIN_FILENO, POLLIN, 0};
+                if (poll(&pfd, 1, kPollMs) <= 0) continue;
+                n = ::read(STDIN_FILENO, chunk.data(), size_t(kReadSize));
+#endif
+            }
+            if (n <= 0) break;
+            ingest(chunk.constData(), n);
+        }
+
+        // 流结束时最后一行可能没有换行符
+        if (!m_carry.isEmpty() && !m_stop) ingest("\n", 1);
+    }
+
+    void push(const char* name, int nameLen, Money amount) {
+        LedgerEvent e;
+        e.amount = amount;
+        auto it = m_accounts.constFind(QByteArray::fromRawData(name, nameLen));
+        if (it != m_accounts.constEnd()) {
+            e.account = it.value();
+        } else {
+            e.account = quint32(m_accounts.size());
+            m_accounts.insert(QByteArray(name, nameLen), e.account);
+            e.name = QString::fromUtf8(name, nameLen);
+        }
+
+        while (!m_ring.tryPush(std::move(e))) {
+            // 队列满：叫醒消费端，等它取走，不丢事件
+            m_stalls.fetch_add(1, std::memory_order_relaxed);
+            signal();
+            if (m_stop.load(std::memory_order_relaxed)) return;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    // 队列由空变非空后只通知一次，直到消费端 drain()
+    void signal() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!m_notified.exchange(true) && m_notify) m_notify();
+    }
+};
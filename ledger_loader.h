@@ -0,0 +1,408 @@
+#pragma once
+
+// 总账流式导入：CSV / 紧凑二进制两种格式
+//
+// CSV: 每行 "科目,金额(元)"，首行表头可选
+// 二进制(.glb): 小端
+//   [0]  char[4]  "GLB1"
+//   [4]  quint32  版本号(1)
+//   [8]  记录区   {quint32 科目序号; qint64 金额(分)} * N
+//   [..] 科目表   {quint16 字节数; UTF-8 名称} * M
+//   [-8] quint64  科目表偏移
+//
+// 文件按块读取，块交给工作线程解析，每个线程维护自己的哈希表，最后合并。
+// 金额一律按分定点累加（见 Money），合计与分块、线程数无关，逐分精确。
+// 原始行只在所在块的生命周期内存在。
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QtEndian>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "money.h"
+
+#if defined(Q_OS_WIN)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+struct LedgerStats {
+    qint64 rows = 0;          // 有效分录行数
+    qint64 skipped = 0;       // 无法解析的行
+    qint64 bytes = 0;         // 读取字节数
+    double seconds = 0;
+    qint64 peakRssKb = 0;     // 进程峰值常驻内存
+
+    double rowsPerSec() const { return seconds > 0 ? rows / seconds : 0; }
+};
+
+class LedgerLoader {
+public:
+    static constexpr char kBinaryMagic[4] = {'G', 'L', 'B', '1'};
+    static constexpr quint32 kBinaryVersion = 1;
+    static constexpr int kRecordSize = 12;
+
+    explicit LedgerLoader(int threads = QThread::idealThreadCount(),
+                          qint64 chunkSize = 4 << 20)
+        : m_threads(qMax(1, threads)), m_chunkSize(chunkSize) {}
+
+    bool load(const QString& path) {
+        m_totals.clear();
+        m_stats = LedgerStats();
+        m_error.clear();
+
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            m_error = file.errorString();
+            return false;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        char magic[4] = {};
+        bool binary = file.peek(magic, 4) == 4 && memcmp(magic, kBinaryMagic, 4) == 0;
+        bool ok = binary ? loadBinary(file) : loadCsv(file);
+
+        m_stats.seconds = timer.nsecsElapsed() / 1e9;
+        m_stats.peakRssKb = peakRssKb();
+        return ok;
+    }
+
+    // 各科目合计
+    const QHash<QString, Money>& totals() const { return m_totals; }
+    const LedgerStats& stats() const { return m_stats; }
+    QString errorString() const { return m_error; }
+
+    void report(const QString& path) const {
+        qDebug().noquote() << QString("总账导入 %1: %2 行 (%3 跳过), %4 个科目, %5 秒, %6 行/秒, 峰值内存 %7 MB")
+                .arg(path)
+                .arg(m_stats.rows)
+                .arg(m_stats.skipped)
+                .arg(m_totals.size())
+                .arg(m_stats.seconds, 0, 'f', 3)
+                .arg(m_stats.rowsPerSec(), 0, 'f', 0)
+                .arg(m_stats.peakRssKb / 1024.0, 0, 'f', 1);
+    }
+
+    // CSV 转二进制（单线程流式，科目表写在文件尾）；科目名称超过 65535 字节时放弃转换
+    static bool convertCsvToBinary(const QString& csvPath, const QString& binPath) {
+        QFile in(csvPath);
+        QFile out(binPath);
+        if (!in.open(QIODevice::ReadOnly) || !out.open(QIODevice::WriteOnly)) return false;
+
+        QHash<QByteArray, quint32> index;
+        QVector<QByteArray> names;
+
+        QDataStream ds(&out);
+        ds.setByteOrder(QDataStream::LittleEndian);
+        ds.writeRawData(kBinaryMagic, 4);
+        ds << kBinaryVersion;
+
+        while (!in.atEnd()) {
+            QByteArray line = in.readLine();
+            const char* name = nullptr;
+            int nameLen = 0;
+            Money amount;
+            if (!parseCsvLine(line.constData(), line.constData() + line.size(), name, nameLen, amount)) continue;
+
+            if (nameLen > 0xFFFF) {     // 科目表长度字段只有 16 位
+                qDebug() << "科目名称过长(" << nameLen << "字节)，放弃转换:" << csvPath;
+                return false;
+            }
+            QByteArray account(name, nameLen);
+
+            auto it = index.find(account);
+            if (it == index.end()) {
+                it = index.insert(account, quint32(names.size()));
+                names.append(account);
+            }
+            ds << it.value() << amount.fen();
+        }
+
+        quint64 tableOffset = quint64(out.pos());
+        for (const QByteArray& name : names) {
+            ds << quint16(name.size());
+            ds.writeRawData(name.constData(), name.size());
+        }
+        ds << tableOffset;
+        return ds.status() == QDataStream::Ok;
+    }
+
+    // 解析 "科目,金额"；金额直接解析成分，避免 locale、临时字符串和浮点舍入（实时流水也用它）
+    static bool parseCsvLine(const char* p, const char* end,
+                             const char*& name, int& nameLen, Money& amount) {
+        while (end > p && (end[-1] == '\n' || end[-1] == '\r')) --end;
+        const char* comma = static_cast<const char*>(memchr(p, ',', end - p));
+        if (!comma || comma == p) return false;
+
+        const char* q = comma + 1;
+        const char* fieldEnd = static_cast<const char*>(memchr(q, ',', end - q));
+        if (!fieldEnd) fieldEnd = end;
+        if (!Money::parse(q, fieldEnd, amount)) return false;
+
+        name = p;
+        nameLen = int(comma - p);
+        return true;
+    }
+
+    static qint64 peakRssKb() {
+#if defined(Q_OS_WIN)
+        PROCESS_MEMORY_COUNTERS pmc;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+            return qint64(pmc.PeakWorkingSetSize / 1024);
+        return 0;
+#elif defined(Q_OS_UNIX)
+        rusage ru;
+        getrusage(RUSAGE_SELF, &ru);
+#if defined(Q_OS_MACOS)
+        return ru.ru_maxrss / 1024;   // macOS 单位是字节
+#else
+        return ru.ru_maxrss;
+#endif
+#else
+        return 0;
+#endif
+    }
+
+private:
+    int m_threads;
+    qint64 m_chunkSize;
+    QHash<QString, Money> m_totals;
+    LedgerStats m_stats;
+    QString m_error;
+
+    // 有界块队列：读线程生产，工作线程消费，内存占用上限约为 容量*块大小
+    class ChunkQueue {
+    public:
+        explicit ChunkQueue(size_t capacity) : m_capacity(capacity) {}
+
+        void push(QByteArray chunk) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notFull.wait(lock, [this] { return m_queue.size() < m_capacity; });
+            m_queue.push_back(std::move(chunk));
+            m_notEmpty.notify_one();
+        }
+
+        bool pop(QByteArray& chunk) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [this] { return !m_queue.empty() || m_closed; });
+            if (m_queue.empty()) return false;
+            chunk = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_notFull.notify_one();
+            return true;
+        }
+
+        void close() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+            m_notEmpty.notify_all();
+        }
+
+    private:
+        size_t m_capacity;
+        std::deque<QByteArray> m_queue;
+        bool m_closed = false;
+        std::mutex m_mutex;
+        std::condition_variable m_notEmpty;
+        std::condition_variable m_notFull;
+    };
+
+    // 把文件当前位置到 end 的内容按块推入队列，由各工作线程处理；
+    // 读取出错或提前读完（文件被截断）时返回 false，原因写入 m_error，已读的块照常处理完
+    template <typename Split, typename Process>
+    bool pump(QFile& file, qint64 end, Split splitPoint, std::vector<Process>& workers) {
+        ChunkQueue queue(size_t(m_threads) * 2);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < m_threads; ++t) {
+            threads.emplace_back([&queue, &workers, t] {
+                QByteArray chunk;
+                while (queue.pop(chunk)) workers[t](chunk);
+            });
+        }
+
+        bool complete = true;
+        QByteArray carry;
+        while (file.pos() < end) {
+            QByteArray chunk = carry + file.read(qMin(m_chunkSize, end - file.pos()));
+            if (chunk.size() == carry.size()) {
+                complete = false;
+                break;
+            }
+            m_stats.bytes += chunk.size() - carry.size();
+
+            int cut = file.pos() < end ? splitPoint(chunk) : chunk.size();
+            carry = chunk.mid(cut);
+            chunk.truncate(cut);
+            if (!chunk.isEmpty()) queue.push(std::move(chunk));
+        }
+        if (!carry.isEmpty()) queue.push(std::move(carry));
+
+        queue.close();
+        for (auto& th : threads) th.join();
+
+        if (file.error() != QFileDevice::NoError) {
+            m_error = "读取失败: " + file.errorString();
+            return false;
+        }
+        if (!complete) {
+            m_error = "文件读取不完整";
+            return false;
+        }
+        return true;
+    }
+
+    struct CsvWorker {
+        QHash<QByteArray, qint64> totals;     // 分
+        qint64 rows = 0;
+        qint64 skipped = 0;
+
+        void operator()(const QByteArray& chunk) {
+            const char* p = chunk.constData();
+            const char* end = p + chunk.size();
+            while (p < end) {
+                const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+                if (!eol) eol = end;
+
+                const char* name = nullptr;
+                int nameLen = 0;
+                Money amount;
+                if (parseCsvLine(p, eol, name, nameLen, amount)) {
+                    // 用 fromRawData 查找，只有新科目才分配内存
+                    auto it = totals.find(QByteArray::fromRawData(name, nameLen));
+                    if (it == totals.end()) it = totals.insert(QByteArray(name, nameLen), 0);
+                    it.value() += amount.fen();
+                    ++rows;
+                } else if (eol - p > 1) {
+                    ++skipped;
+                }
+                p = eol + 1;
+            }
+        }
+    };
+
+    bool loadCsv(QFile& file) {
+        std::vector<CsvWorker> workers(m_threads);
+        bool ok = pump(file, file.size(), [](const QByteArray& chunk) {
+            int nl = chunk.lastIndexOf('\n');
+            return nl < 0 ? 0 : nl + 1;
+        }, workers);
+        if (!ok) return false;      // 部分合计比真实值小，不交出去
+
+        // 合并各线程结果
+        QHash<QByteArray, qint64> merged;
+        for (const CsvWorker& w : workers) {
+            for (auto it = w.totals.cbegin(); it != w.totals.cend(); ++it)
+                merged[it.key()] += it.value();
+            m_stats.rows += w.rows;
+            m_stats.skipped += w.skipped;
+        }
+        // 不同字节串可能解码成同一个名称（如非法 UTF-8 都变成 U+FFFD），累加而不是覆盖
+        for (auto it = merged.cbegin(); it != merged.cend(); ++it)
+            m_totals[QString::fromUtf8(it.key())] += Money::fromFen(it.value());
+        return true;
+    }
+
+    struct BinaryWorker {
+        std::vector<qint64> totals;   // 按科目序号累加（分）
+        qint64 rows = 0;
+        qint64 skipped = 0;
+        std::vector<quint32> accounts;  // 本块拆出的两列，复用容量
+        std::vector<qint64> fen;
+
+        void operator()(const QByteArray& chunk) {
+            // 记录是 12 字节交错存放的，先拆成连续的两列，分组求和的内层循环只读连续内存
+            const qint64 n = chunk.size() / kRecordSize;
+            accounts.resize(size_t(n));
+            fen.resize(size_t(n));
+            const uchar* p = reinterpret_cast<const uchar*>(chunk.constData());
+            for (qint64 i = 0; i < n; ++i, p += kRecordSize) {
+                accounts[size_t(i)] = qFromLittleEndian<quint32>(p);
+                fen[size_t(i)] = qFromLittleEndian<qint64>(p + 4);
+            }
+
+            // 块之间已经并行，这里单线程
+            const qint64 bad = Money::groupSumFen(accounts.data(), fen.data(), n,
+                                                  totals.data(), int(totals.size()), 1);
+            rows += n - bad;
+            skipped += bad;
+            if (chunk.size() % kRecordSize != 0) ++skipped;     // 记录区末尾不完整的一条
+        }
+    };
+
+    bool loadBinary(QFile& file) {
+        // 先读文件尾的科目表
+        if (file.size() < 16) {
+            m_error = "文件过短";
+            return false;
+        }
+        file.seek(4);
+        const quint32 version = qFromLittleEndian<quint32>(
+                reinterpret_cast<const uchar*>(file.read(4).constData()));
+        if (version != kBinaryVersion) {
+            m_error = QString("不支持的版本号 %1").arg(version);
+            return false;
+        }
+
+        file.seek(file.size() - 8);
+        quint64 tableOffset = qFromLittleEndian<quint64>(
+                reinterpret_cast<const uchar*>(file.read(8).constData()));
+        if (tableOffset < 8 || tableOffset > quint64(file.size() - 8)) {
+            m_error = "科目表偏移无效";
+            return false;
+        }
+
+        file.seek(qint64(tableOffset));
+        QByteArray table = file.read(file.size() - 8 - qint64(tableOffset));
+        QVector<QString> names;
+        for (int pos = 0; pos < table.size();) {
+            // 每条先确认长度字段和名称都在科目表内，截断/损坏的文件不往后读
+            const int left = table.size() - pos - 2;
+            const int len = left < 0 ? -1 : qFromLittleEndian<quint16>(
+                    reinterpret_cast<const uchar*>(table.constData() + pos));
+            if (len < 0 || len > left) {
+                m_error = "科目表损坏";
+                return false;
+            }
+            names.append(QString::fromUtf8(table.constData() + pos + 2, len));
+            pos += 2 + len;
+        }
+
+        std::vector<BinaryWorker> workers(m_threads);
+        for (BinaryWorker& w : workers) w.totals.assign(names.size(), 0);
+
+        file.seek(8);
+        bool ok = pump(file, qint64(tableOffset), [](const QByteArray& chunk) {
+            return chunk.size() - chunk.size() % kRecordSize;
+        }, workers);
+        if (!ok) return false;
+
+        std::vector<qint64> merged(names.size(), 0);
+        for (const BinaryWorker& w : workers) {
+            Money::addFen(merged.data(), w.totals.data(), names.size());
+            m_stats.rows += w.rows;
+            m_stats.skipped += w.skipped;
+        }
+        for (int i = 0; i < names.size(); ++i)
+            m_totals[names[i]] += Money::fromFen(merged[i]);
+        return true;
+    }
+};
@@ -0,0 +1,137 @@
+// 总账流水回放：把录制的 CSV 流水（每行 "科目,金额(元)"）按指定速率发给实时看板
+//
+// 用法:
+//   ledger_replay <流水.csv> [--socket 名称] [--rate 条/秒] [--loop]
+// 不带 --socket 时写到标准输出，直接接管道:
+//   ledger_replay journal.csv --rate 200000 | financial --live -
+// 带 --socket 时作为本地套接字服务端（Windows 上即命名管道），等 financial --live 名称 连上后发送。
+// --rate 0 表示不限速，只受接收端反压；每秒在标准错误输出实际速率。
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QThread>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    auto value = [&args](const QString& name, const QString& def = QString()) {
+        int i = args.indexOf(name);
+        return i >= 0 && i + 1 < args.size() ? args[i + 1] : def;
+    };
+    if (args.size() < 2 || args[1].startsWith("--")) {
+        fprintf(stderr, "用法: ledger_replay <流水.csv> [--socket 名称] [--rate 条/秒] [--loop]\n");
+        return 2;
+    }
+    const QString socketName = value("--socket");
+    const double rate = value("--rate", "0").toDouble();
+    const bool loop = args.contains("--loop");
+
+    // 整个文件读进内存，记下每行的起止，发送时按行切片
+    QFile in(args[1]);
+    if (!in.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "无法读取 %s\n", qPrintable(args[1]));
+        return 1;
+    }
+    QByteArray data = in.readAll();
+    if (!data.endsWith('\n')) data.append('\n');
+    std::vector<int> lineEnds;      // 每行末尾（含换行符）的偏移
+    for (int pos = 0; pos < data.size();) {
+        const char* eol = static_cast<const char*>(memchr(data.constData() + pos, '\n', data.size() - pos));
+        int end = int(eol - data.constData()) + 1;
+        if (end - pos > 1) lineEnds.push_back(end);
+        pos = end;
+    }
+    if (lineEnds.empty()) {
+        fprintf(stderr, "%s 没有流水行\n", qPrintable(args[1]));
+        return 1;
+    }
+
+    // 输出端
+    QLocalServer server;
+    std::unique_ptr<QLocalSocket> socket;
+    QFile stdoutFile;
+    QIODevice* out = nullptr;
+    if (!socketName.isEmpty()) {
+        QLocalServer::removeServer(socketName);     // 清掉上次异常退出留下的套接字文件
+        if (!server.listen(socketName)) {
+            fprintf(stderr, "监听失败 %s: %s\n", qPrintable(socketName), qPrintable(server.errorString()));
+            return 1;
+        }
+        fprintf(stderr, "等待连接 %s ...\n", qPrintable(server.fullServerName()));
+        server.waitForNewConnection(-1);
+        socket.reset(server.nextPendingConnection());
+        out = socket.get();
+    } else {
+        stdoutFile.open(stdout, QIODevice::WriteOnly | QIODevice::Unbuffered);
+        out = &stdoutFile;
+    }
+
+    // 令牌桶：按开始以来的时间算出应发条数，每次最多补发 1/100 秒的量，避免卡顿后突发
+    const qint64 burst = rate > 0 ? qMax<qint64>(1, qint64(rate / 100)) : 4096;
+    QElapsedTimer clock;
+    clock.start();
+    qint64 sent = 0;
+    qint64 reportSent = 0;
+    qint64 reportNs = 0;
+    size_t next = 0;
+    QByteArray batch;
+
+    while (true) {
+        qint64 due = rate > 0 ? qint64(clock.nsecsElapsed() / 1e9 * rate) : sent + burst;
+        if (due - sent > burst) {
+            // 发送端跟不上（接收端反压）时不追补
+            clock.restart();
+            sent = 0;
+            reportSent = 0;
+            reportNs = 0;
+            due = burst;
+        }
+        if (due <= sent) {
+            QThread::usleep(500);
+            continue;
+        }
+
+        batch.clear();
+        for (; sent < due; ++sent) {
+            if (next == lineEnds.size()) {
+                if (!loop) break;
+                next = 0;
+            }
+            const int begin = next == 0 ? 0 : lineEnds[next - 1];
+            batch.append(data.constData() + begin, lineEnds[next] - begin);
+            ++next;
+        }
+        if (batch.isEmpty()) break;
+
+        if (out->write(batch) != batch.size()) break;
+        if (socket) {
+            socket->waitForBytesWritten(-1);
+            if (socket->state() != QLocalSocket::ConnectedState) break;
+        } else if (!stdoutFile.flush()) {
+            // 管道上的 stdout 是全缓冲的，Unbuffered 不会冲刷 stdio 缓冲区，每批都要手动冲出去
+            break;
+        }
+
+        const qint64 now = clock.nsecsElapsed();
+        if (now - reportNs >= 1000000000) {
+            fprintf(stderr, "%.0f 条/秒\n", (sent - reportSent) / ((now - reportNs) / 1e9));
+            reportSent = sent;
+            reportNs = now;
+        }
+        if (!loop && next == lineEnds.size()) break;
+    }
+
+    if (socket) {
+        socket->flush();
+        socket->disconnectFromServer();
+        if (socket->state() != QLocalSocket::UnconnectedState) socket->waitForDisconnected(1000);
+    }
+    return 0;
+}
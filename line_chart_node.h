@@ -0,0 +1,213 @@
+#pragma once
+
+// 价格历史折线节点（可缩放、平移）
+//
+// 按当前日期窗口和绘图区宽度从 PricePyramid 挑一层读点（每像素列约 2 个节点），
+// 重建时生成 min/max 包络、last 折线和坐标刻度，绘制时只画缓存的路径和文字。
+// 缩放、平移只改日期窗口并使本节点失效，读点量与历史长度无关。
+
+#include <QDate>
+#include <QPainterPath>
+#include <cmath>
+#include <vector>
+#include "chart_scene.h"
+#include "price_history.h"
+
+class LineChartNode : public ChartNode {
+public:
+    struct Style {
+        int leftInset = 55;         // 绘图区离边框
+        int rightInset = 15;
+        int topInset = 35;
+        int bottomInset = 30;
+        QColor lineColor = QColor(100, 200, 255);
+        QColor bandColor = QColor(100, 200, 255, 60);   // min/max 包络
+        QColor gridColor = QColor(255, 255, 255, 30);
+        QColor textColor = QColor(200, 220, 255, 200);
+        double minSpanDays = 7;     // 最多放大到一周
+    };
+
+    Style style;
+
+    std::function<QString()> emptyText;     // 没有序列时的提示，可空
+
+    using ChartNode::ChartNode;
+
+    // 换序列时窗口回到全程
+    void setSeries(const PricePyramid* series) {
+        m_series = series;
+        resetWindow();
+    }
+
+    const PricePyramid* series() const { return m_series; }
+
+    void resetWindow() {
+        if (m_series && !m_series->empty()) {
+            m_from = m_series->firstDay();
+            m_to = qMax<double>(m_series->lastDay(), m_from + style.minSpanDays);
+        }
+        invalidate();
+    }
+
+    QRect plotRect() const {
+        return bounds().adjusted(style.leftInset, style.topInset, -style.rightInset, -style.bottomInset);
+    }
+
+    // 以绘图区内 x 处的日期为中心缩放，factor < 1 放大；返回窗口是否变化
+    bool zoom(double factor, int x) {
+        if (!hasData()) return false;
+        const QRect plot = plotRect();
+        const double t = qBound(0.0, double(x - plot.left()) / plot.width(), 1.0);
+        const double anchor = m_from + (m_to - m_from) * t;
+        const double span = qBound(style.minSpanDays, (m_to - m_from) * factor, fullSpan());
+        return setWindow(anchor - span * t, anchor - span * t + span);
+    }
+
+    // 平移 dx 像素（正数向右拖，看更早的日期）；返回窗口是否变化
+    bool pan(int dx) {
+        if (!hasData() || dx == 0) return false;
+        const double days = -double(dx) / plotRect().width() * (m_to - m_from);
+        return setWindow(m_from + days, m_to + days);
+    }
+
+    void paint(QPainter& p) const override {
+        paintFrame(p);
+        if (!hasData()) {
+            if (!m_emptyText.isEmpty()) {
+                p.setPen(QColor(200, 220, 255, 180));
+                p.setFont(vizFont(11));
+                drawCachedText(p, bounds(), Qt::AlignCenter, m_emptyText);
+            }
+            return;
+        }
+
+        const QRect plot = plotRect();
+
+        // 网格和刻度
+        p.setPen(style.gridColor);
+        for (const Tick& t : m_yTicks) p.drawLine(plot.left(), t.pos, plot.right(), t.pos);
+        for (const Tick& t : m_xTicks) p.drawLine(t.pos, plot.top(), t.pos, plot.bottom());
+        p.setPen(style.textColor);
+        p.setFont(vizFont(8));
+        for (const Tick& t : m_yTicks)
+            drawCachedText(p, bounds().left(), t.pos - 10, style.leftInset - 6, 20,
+                           Qt::AlignRight | Qt::AlignVCenter, t.text);
+        for (const Tick& t : m_xTicks)
+            drawCachedText(p, t.pos - 40, plot.bottom() + 4, 80, 20, Qt::AlignHCenter | Qt::AlignTop, t.text);
+
+        // 包络 + 折线，裁到绘图区
+        p.save();
+        p.setClipRect(plot, Qt::IntersectClip);
+        p.setPen(Qt::NoPen);
+        p.setBrush(style.bandColor);
+        p.drawPath(m_band);
+        p.setBrush(Qt::NoBrush);
+        p.setPen(vizPen(style.lineColor, 1.5));
+        p.drawPath(m_line);
+        p.restore();
+
+        // 取点说明：所选层和点数
+        p.setPen(style.textColor);
+        drawCachedText(p, plot.adjusted(0, -18, 0, 0), Qt::AlignTop | Qt::AlignRight, m_caption);
+    }
+
+protected:
+    void rebuild() override {
+        m_emptyText = emptyText ? emptyText() : QString();
+        m_band = QPainterPath();
+        m_line = QPainterPath();
+        m_xTicks.clear();
+        m_yTicks.clear();
+        if (!hasData()) return;
+
+        // 按窗口挑层读点（两侧各多一个，线能连出窗口）
+        const QRect plot = plotRect();
+        m_points.clear();
+        const int level = m_series->visit(qint32(std::floor(m_from)), qint32(std::ceil(m_to)), plot.width(),
+                                          [this](const PricePoint& pt) { m_points.push_back(pt); });
+
+        float lo = m_points.front().min;
+        float hi = m_points.front().max;
+        for (const PricePoint& pt : m_points) {
+            lo = qMin(lo, pt.min);
+            hi = qMax(hi, pt.max);
+        }
+        const double pad = qMax(0.01, (hi - lo) * 0.08);
+        const double yMin = qMax(0.0, lo - pad);
+        const double yMax = hi + pad;
+
+        auto xOf = [&](qint32 day) { return plot.left() + (day - m_from) / (m_to - m_from) * plot.width(); };
+        auto yOf = [&](double v) { return plot.bottom() - (v - yMin) / (yMax - yMin) * plot.height(); };
+
+        // 包络：max 从左到右，min 从右到左，闭合成一个多边形
+        QPolygonF band;
+        band.reserve(int(m_points.size()) * 2);
+        QPolygonF line;
+        line.reserve(int(m_points.size()));
+        for (const PricePoint& pt : m_points) {
+            band.append(QPointF(xOf(pt.day), yOf(pt.max)));
+            line.append(QPointF(xOf(pt.day), yOf(pt.last)));
+        }
+        for (auto it = m_points.rbegin(); it != m_points.rend(); ++it) band.append(QPointF(xOf(it->day), yOf(it->min)));
+        m_band.addPolygon(band);
+        m_band.closeSubpath();
+        m_line.addPolygon(line);
+
+        // QPainterPath 的包围盒是惰性计算的，这里先算好，paint() 只读
+        m_band.controlPointRect();
+        m_band.boundingRect();
+        m_line.controlPointRect();
+        m_line.boundingRect();
+
+        for (int i = 0; i <= 4; ++i) {
+            const double v = yMin + (yMax - yMin) * i / 4;
+            m_yTicks.push_back({int(yOf(v)), QString::number(v, 'f', 2)});
+        }
+
+        // 日期刻度：跨度超过 3 年只标年，超过 90 天标年月，否则标月日
+        const double span = m_to - m_from;
+        const QString format = span > 3 * 365 ? "yyyy" : (span > 90 ? "yyyy-MM" : "MM-dd");
+        for (int i = 0; i <= 4; ++i) {
+            const qint32 day = qint32(std::lround(m_from + span * i / 4));
+            m_xTicks.push_back({int(xOf(day)), QDate::fromJulianDay(day).toString(format)});
+        }
+
+        m_caption = QString("第 %1/%2 层 · %3 点 / %4 样本")
+                .arg(level).arg(m_series->levelCount() - 1).arg(m_points.size()).arg(m_series->size());
+    }
+
+private:
+    struct Tick {
+        int pos;
+        QString text;
+    };
+
+    const PricePyramid* m_series = nullptr;
+    double m_from = 0;          // 日期窗口（儒略日，可以是小数）
+    double m_to = 0;
+    std::vector<PricePoint> m_points;       // 重建时的临时缓冲，复用容量
+    QPainterPath m_band;
+    QPainterPath m_line;
+    std::vector<Tick> m_xTicks;
+    std::vector<Tick> m_yTicks;
+    QString m_caption;
+    QString m_emptyText;
+
+    bool hasData() const { return m_series && !m_series->empty(); }
+
+    double fullSpan() const {
+        return qMax<double>(m_series->lastDay() - m_series->firstDay(), style.minSpanDays);
+    }
+
+    // 窗口不超出序列全程
+    bool setWindow(double from, double to) {
+        const double span = to - from;
+        from = qBound<double>(m_series->firstDay(), from, m_series->firstDay() + fullSpan() - span);
+        to = from + span;
+        if (from == m_from && to == m_to) return false;
+        m_from = from;
+        m_to = to;
+        invalidate();
+        return true;
+    }
+};
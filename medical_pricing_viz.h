@@ -0,0 +1,837 @@
+#pragma once
+
+#include <QWidget>
+#include <QPainter>
+#include <QFont>
+#include <QVector>
+#include <QFile>
+#include <QImage>
+#include <QImageReader>
+#include <QCoreApplication>
+#include <QPointer>
+#include <QThreadPool>
+#include <QPaintEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QKeyEvent>
+#include <QLineEdit>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include "bar_chart_node.h"
+#include "catalog_search.h"
+#include "catalog_store.h"
+#include "chart_scene.h"
+#include "hover_overlay.h"
+#include "line_chart_node.h"
+#include "paint_profiler.h"
+#include "pie_chart_node.h"
+#include "price_histogram.h"
+#include "price_history.h"
+#include "snapshot.h"
+#include "table_node.h"
+#include "viz_text_cache.h"
+
+// 录入用的行结构；看板内部按列存储（见 CatalogStore）
+struct Item {
+    QString name;
+    double price;
+    QString spec;
+};
+
+// 耗材看板：数据 + 绘制，不依赖 QWidget，可在工作线程里画到 QImage 上
+class MedicalDashboard {
+public:
+    MedicalDashboard() {
+        // 提取的数据
+        setItems({
+                {"一次性使用袋式输液器 带针", 6.65, "FV3-250mm 0.55"},
+                {"一次性使用输液器 带针", 6.60, "BV4 0.7*25TWLB*25支"},
+                {"一次性使用无菌溶药注射器 带针", 5.82, "RY50ml 1.6*30TWX"},
+                {"一次性使用无菌注射器 带针", 3.16, "1ml 0.45*15RWSB"},
+                {"一次性使用静脉输液针", 1.5, "0.55"},
+                {"一次性使用无菌注射针", 1.66, "0.45-0.7"}
+        });
+        setupScene();
+    }
+
+    void setSize(const QSize& size) {
+        if (size == m_size) return;
+        m_size = size;
+        m_backgroundDirty = true;
+    }
+
+    // 背景图为空时使用渐变背景
+    void setBackground(const QImage& image) {
+        m_background = image;
+        m_useGradientBg = image.isNull();
+        m_backgroundDirty = true;
+    }
+
+    void setItems(const QVector<Item>& items) {
+        m_catalog.clear();
+        m_catalog.reserve(items.size());
+        for (const Item& item : items) m_catalog.append(item.name, item.price, item.spec);
+        rebuildView();
+    }
+
+    const CatalogStore& catalog() const { return m_catalog; }
+
+    // 打开快照：目录列、显示顺序、价格区间全部直接映射，不解析、不排序；失败时保持原数据
+    bool openSnapshot(const QString& path) {
+        QElapsedTimer timer;
+        timer.start();
+
+        QString error;
+        std::shared_ptr<SnapshotFile> file = SnapshotFile::open(path, SnapshotFile::Medical, &error);
+        CatalogStore catalog;
+        Column<quint32> order;
+        Column<double> prices;
+        PriceHistogram histogram;
+        bool ok = file && catalog.mapSnapshot(file)
+                  && SnapshotFile::mapColumn(file, "ORDR", order)
+                  && SnapshotFile::mapColumn(file, "PRIC", prices)
+                  && histogram.mapSnapshot(file)
+                  && order.size() == catalog.size() && SnapshotFile::allBelow(order, catalog.size())
+                  && histogram.total() == catalog.size();       // total() 即 BINS 列长度
+        if (!ok) {
+            qDebug() << "快照打开失败:" << path << (error.isEmpty() ? QString("缺少耗材列或数据损坏") : error);
+            return false;
+        }
+
+        m_catalog = std::move(catalog);
+        m_order = std::move(order);
+        m_prices = std::move(prices);      // 快照按显示顺序写出，PRIC 同时是排好序的价格列
+        m_histogram = std::move(histogram);
+        m_quantileBins = 0;
+        m_search.invalidate();
+        updateFilteredView();
+
+        qDebug().noquote() << QString("耗材快照: %1 项, 映射 %2 ms")
+                .arg(m_catalog.size()).arg(timer.nsecsElapsed() / 1e6, 0, 'f', 2);
+        return true;
+    }
+
+    // 写快照：行按当前显示顺序重排写出，打开后显示顺序就是行号顺序
+    bool writeSnapshot(const QString& path) const {
+        const qint64 n = m_prices.size();
+        std::vector<quint32> names(size_t(n)), specs(size_t(n)), order(size_t(n));
+        for (qint64 i = 0; i < n; ++i) {
+            names[i] = m_catalog.nameId(m_order[i]);
+            specs[i] = m_catalog.specId(m_order[i]);
+            order[i] = quint32(i);
+        }
+
+        std::vector<quint32> offsets;
+        std::vector<char16_t> chars;
+        SnapshotWriter w(SnapshotFile::Medical);
+        w.add("PRIC", m_prices);
+        w.add("NAME", names);
+        w.add("SPEC", specs);
+        w.add("ORDR", order);
+        m_catalog.strings().writeSnapshot(w, offsets, chars);
+        m_histogram.writeSnapshot(w);
+
+        QString error;
+        if (!w.finish(path, &error)) {
+            qDebug() << "快照写入失败:" << path << error;
+            return false;
+        }
+        return true;
+    }
+
+    // 固定价格区间边界（元），默认 {2, 5}：低价 <2，中价 2~5，高价 ≥5
+    void setPriceBands(const QVector<double>& edges) {
+        m_quantileBins = 0;
+        m_histogram.setEdges(edges);
+        updateHistogram();
+    }
+
+    // 按分位数等频分成 bins 个区间，数据变化时重新取边界
+    void setQuantileBands(int bins) {
+        m_quantileBins = qMax(1, bins);
+        updateHistogram();
+    }
+
+    const PriceHistogram& histogram() const { return m_histogram; }
+
+    // 名称/规格筛选：空白分隔的词都要出现（不区分大小写），空串取消筛选。
+    // 柱状图、饼图、清单都只显示匹配项；区间边界沿用全量数据，颜色不随筛选变化。
+    void setFilter(const QString& query) {
+        m_search.setQuery(query, m_catalog, m_order);
+        m_table.scrollTo(0);
+        updateFilteredView();
+    }
+
+    const CatalogSearch& search() const { return m_search; }
+
+    // 耗材清单 CSV：每行 "名称,单价,规格"，首行表头可选
+    bool loadCatalog(const QString& path) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            qDebug() << "耗材清单打开失败:" << path << file.errorString();
+            return false;
+        }
+
+        // 直接写入列存储，名称/规格在字符串池里去重
+        m_catalog.clear();
+        while (!file.atEnd()) {
+            QString line = QString::fromUtf8(file.readLine()).trimmed();
+            int c1 = line.indexOf(',');
+            int c2 = c1 < 0 ? -1 : line.indexOf(',', c1 + 1);
+            if (c1 <= 0) continue;
+
+            bool ok = false;
+            double price = line.mid(c1 + 1, c2 < 0 ? -1 : c2 - c1 - 1).trimmed().toDouble(&ok);
+            if (!ok) continue;   // 表头或坏行
+            QStringView view(line);
+            m_catalog.append(view.left(c1).trimmed(), price,
+                             c2 < 0 ? QStringView() : view.mid(c2 + 1).trimmed());
+        }
+        rebuildView();
+
+        qDebug().noquote() << QString("耗材清单: %1 项, 去重字符串 %2 条, 约 %3 MB")
+                .arg(m_catalog.size())
+                .arg(m_catalog.strings().size())
+                .arg(m_catalog.memoryBytes() / (1024.0 * 1024.0), 0, 'f', 1);
+        return true;
+    }
+
+    // 价格历史 CSV（见 PriceHistory::load），导入时为每个 SKU 建金字塔；失败时保持原数据
+    bool loadPriceHistory(const QString& path) {
+        QElapsedTimer timer;
+        timer.start();
+        PriceHistory history;
+        QString error;
+        if (!history.load(path, &error)) {
+            qDebug() << "价格历史导入失败:" << path << error;
+            return false;
+        }
+        setPriceHistory(std::move(history));
+        qDebug().noquote() << QString("价格历史: %1 个 SKU, %2 个样本, 金字塔约 %3 MB, 导入 %4 ms")
+                .arg(m_history.seriesCount()).arg(m_history.sampleCount())
+                .arg(m_history.memoryBytes() / (1024.0 * 1024.0), 0, 'f', 1)
+                .arg(timer.nsecsElapsed() / 1e6, 0, 'f', 1);
+        return true;
+    }
+
+    // 整体替换价格历史；正在显示的走势图回到饼图
+    void setPriceHistory(PriceHistory history) {
+        hideHistory();
+        m_history = std::move(history);
+    }
+
+    // 在饼图位置显示第 i 个显示项的价格走势（全程）；没有历史时仍切换过去，显示提示
+    void showHistory(int i) {
+        clearHover();
+        m_historyName = itemName(i);
+        m_historyChart.setSeries(m_history.find(m_catalog.name(shownRow(i)), m_catalog.spec(shownRow(i))));
+        m_pie.setVisible(false);
+        m_historyChart.setVisible(true);
+    }
+
+    void hideHistory() {
+        clearHover();
+        m_historyChart.setSeries(nullptr);
+        m_historyChart.setVisible(false);
+        m_pie.setVisible(true);
+    }
+
+    bool historyVisible() const { return m_historyChart.isVisible(); }
+
+    // 走势图缩放（factor < 1 放大，以 x 处日期为中心）、平移、复位；返回是否需要重绘（只有走势图失效）
+    bool zoomHistory(double factor, int x) { return historyVisible() && m_historyChart.zoom(factor, x); }
+    bool panHistory(int dx) { return historyVisible() && m_historyChart.pan(dx); }
+
+    void resetHistoryZoom() {
+        if (historyVisible()) m_historyChart.resetWindow();
+    }
+
+    // 清单里 pos 处是第几个显示项，不在表体内返回 -1
+    int tableRowAt(const QPoint& pos) const { return m_table.hitTest(pos).first; }
+
+    // 鼠标悬停：依次问柱状图、饼图、清单命中了哪一项，只查各节点重建时建好的索引，不碰绘制。
+    // 命中项变化时换高亮和提示框，返回是否需要重绘（只有这两个小节点失效）
+    bool hover(const QPoint& pos) {
+        const ChartNode* node = &m_bars;
+        ChartHit hit = m_bars.hitTest(pos);
+        if (!hit.isValid()) {
+            node = &m_pie;
+            hit = m_pie.hitTest(pos);
+        }
+        if (!hit.isValid()) {
+            node = &m_table;
+            hit = m_table.hitTest(pos);
+        }
+        if (!hit.isValid()) node = nullptr;
+        if (node == m_hoverNode && hit == m_hoverHit) return false;
+        m_hoverNode = node;
+        m_hoverHit = hit;
+
+        const int count = int(shownPrices().size());
+        if (node == &m_bars && hit.last < count) {
+            m_hover.show(m_bars.hitShape(hit), barTooltip(hit), pos, rect());
+        } else if (node == &m_pie && hit.first < shownHistogram().binCount()) {
+            m_hover.show(m_pie.hitShape(hit), bandTooltip(hit.first), pos, rect());
+        } else if (node == &m_table && hit.first < count) {
+            m_hover.show(m_table.hitShape(hit), itemTooltip(hit.first), pos, rect());
+        } else {
+            m_hover.hide();
+        }
+        return true;
+    }
+
+    // 数据、筛选变化或饼图/走势图切换后命中项和几何都可能变了：先撤掉提示，鼠标再动时重新命中
+    void clearHover() {
+        m_hoverNode = nullptr;
+        m_hoverHit = ChartHit();
+        m_hover.hide();
+    }
+
+    // 表格滚动 rows 行（正数向下），返回是否需要重绘（只有表体失效）
+    bool scrollTable(int rows) {
+        return m_table.scrollBy(qint64(rows) * m_table.viewport().rowHeight());
+    }
+
+    // 滚轮滚动表格：有像素增量（触控板、高精度滚轮）时按像素滚，否则按角度每格（120）3 行，
+    // 不足一格的小增量也按比例滚，不会被整除成 0。返回是否需要重绘（只有表体失效）
+    bool scrollTableByWheel(const QPoint& pixelDelta, const QPoint& angleDelta) {
+        const qint64 dy = !pixelDelta.isNull() ? -qint64(pixelDelta.y())
+                          : -qint64(angleDelta.y()) * 3 * m_table.viewport().rowHeight() / 120;
+        return m_table.scrollBy(dy);
+    }
+
+    // 数据、区间或筛选变化后待重绘的区域（各失效节点的范围），窗口据此局部 update()
+    QRegion dirtyRegion() const { return m_scene.dirtyRegion(); }
+
+    void render(QPainter& p, const QRect& dirty, qreal dpr) {
+        m_profiler.beginFrame();
+
+        // 1~2. 背景 + 半透明遮罩：预合成的缓存层，只按脏区 1:1 拷贝
+        {
+            PAINT_SCOPE(m_profiler, "background");
+            ensureBackgroundLayer(dpr);
+            p.drawImage(QRectF(dirty), m_backgroundLayer,
+                        QRectF(QPointF(dirty.topLeft()) * dpr, QSizeF(dirty.size()) * dpr));
+        }
+
+        p.setRenderHint(QPainter::Antialiasing);
+
+        // 3. 绘制标题和各个图表节点（只重建失效的节点，只画与脏区相交的节点）
+        {
+            PAINT_SCOPE(m_profiler, "title");
+            drawTitle(p);
+        }
+        {
+            PAINT_SCOPE(m_profiler, "prepare");
+            m_scene.sync();
+        }
+        m_scene.paint(p, dirty, &m_profiler);
+
+        m_profiler.endFrame();
+        if (m_profiler.enabled()) m_profiler.drawHud(p, hudOrigin());
+    }
+
+    PaintProfiler& profiler() { return m_profiler; }
+    static QPoint hudOrigin() { return QPoint(8, 68); }
+
+    // 布局区域
+    static QRect barChartArea() { return QRect(50, 80, 400, 300); }
+    static QRect pieChartArea() { return QRect(500, 80, 450, 300); }
+    static QRect tableArea()    { return QRect(50, 410, 900, 300); }
+
+private:
+    QSize m_size{1000, 750};
+    QImage m_background;
+    bool m_useGradientBg = true;
+    QImage m_backgroundLayer;       // 缩放后的背景 + 遮罩，尺寸/DPR/背景图变化时重建
+    bool m_backgroundDirty = true;
+    PaintProfiler m_profiler;       // 绘制阶段计时
+    CatalogStore m_catalog;         // 列式存储（录入顺序）
+    Column<quint32> m_order;        // 显示顺序 -> 行号，按价格从高到低
+    Column<double> m_prices;        // 连续价格列，与 m_order 同序
+    PriceHistogram m_histogram;     // 价格区间，柱色/饼图/表格共用
+    int m_quantileBins = 0;         // >0 时按分位数分箱
+    CatalogSearch m_search;         // 名称/规格筛选
+    Column<double> m_filteredPrices;        // 筛选时显示的价格列（仍按价格从高到低）
+    PriceHistogram m_filteredHistogram;     // 筛选结果的区间计数
+    ChartScene m_scene;             // 柱状图、饼图、清单三个节点
+    BarChartNode m_bars{"drawBarChart", barChartArea()};
+    PieChartNode m_pie{"drawPieChart", pieChartArea()};
+    TableNode m_table{"drawTable", tableArea(), 35};
+    PriceHistory m_history;         // 每个 SKU 的价格历史金字塔
+    LineChartNode m_historyChart{"drawPriceHistory", pieChartArea()};   // 与饼图轮流显示
+    QString m_historyName;
+    HoverOverlay m_hover;           // 悬停高亮 + 提示框，叠在最上层
+    const ChartNode* m_hoverNode = nullptr;     // 当前命中的节点和项
+    ChartHit m_hoverHit;
+
+    int width() const { return m_size.width(); }
+    int height() const { return m_size.height(); }
+    QRect rect() const { return QRect(QPoint(0, 0), m_size); }
+
+    void ensureBackgroundLayer(qreal dpr) {
+        QSize pixelSize = (QSizeF(m_size) * dpr).toSize();
+        if (!m_backgroundDirty && m_backgroundLayer.size() == pixelSize
+                && m_backgroundLayer.devicePixelRatio() == dpr) {
+            return;
+        }
+
+        m_backgroundLayer = QImage(pixelSize, QImage::Format_ARGB32_Premultiplied);
+        m_backgroundLayer.setDevicePixelRatio(dpr);
+        m_backgroundLayer.fill(Qt::transparent);
+
+        QPainter p(&m_backgroundLayer);
+        if (!m_background.isNull()) {
+            // 按物理像素平滑缩放一次，透明度直接预乘进缓存层
+            QImage scaled = m_background.scaled(pixelSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            scaled.setDevicePixelRatio(dpr);
+            p.setOpacity(0.6);
+            p.drawImage(0, 0, scaled);
+            p.setOpacity(1.0);
+        } else if (m_useGradientBg) {
+            // 使用渐变色背景
+            QLinearGradient gradient(0, 0, width(), height());
+            gradient.setColorAt(0, QColor(20, 30, 48));     // 深蓝
+            gradient.setColorAt(1, QColor(36, 59, 85));     // 蓝灰
+            p.fillRect(rect(), gradient);
+        } else {
+            p.fillRect(rect(), QColor(15, 15, 35)); // 纯色深蓝背景
+        }
+
+        // 半透明遮罩，让前景内容更清晰
+        p.fillRect(rect(), QColor(0, 0, 0, 100));
+        m_backgroundDirty = false;
+    }
+
+    // 显示顺序：行号置换按价格从高到低排序，同时得到排好序的价格列
+    void rebuildView() {
+        std::vector<quint32>& order = m_order.mutableData();
+        order = m_catalog.allRows();
+        m_catalog.sortByPriceDesc(order, &m_prices.mutableData());
+        m_search.invalidate();
+        updateHistogram();
+    }
+
+    // 当前显示的数据：有筛选时只含匹配项
+    const Column<double>& shownPrices() const { return m_search.active() ? m_filteredPrices : m_prices; }
+    const PriceHistogram& shownHistogram() const { return m_search.active() ? m_filteredHistogram : m_histogram; }
+    quint32 shownRow(int i) const { return m_order[m_search.active() ? m_search.positions()[size_t(i)] : i]; }
+
+    // 显示的第 i 项的名称/规格（只在格式化可见行时拷贝）
+    QString itemName(int i) const { return m_catalog.name(shownRow(i)).toString(); }
+    QString itemSpec(int i) const { return m_catalog.spec(shownRow(i)).toString(); }
+
+    // 数据或区间设置变化后调用；区间号参与柱状图分桶着色，一并使缓存失效
+    void updateHistogram() {
+        if (m_quantileBins > 0)
+            m_histogram.setEdges(PriceHistogram::quantileEdges(m_prices.data(), qint64(m_prices.size()), m_quantileBins));
+        m_histogram.compute(m_prices.data(), qint64(m_prices.size()));
+        updateFilteredView();
+    }
+
+    // 数据、区间或筛选条件变化后重取匹配项的价格列和区间计数
+    void updateFilteredView() {
+        clearHover();
+        m_scene.invalidateAll();
+        if (!m_search.active()) {
+            m_filteredPrices.clear();
+            return;
+        }
+        m_search.refresh(m_catalog, m_order);
+        const std::vector<quint32>& positions = m_search.positions();
+        std::vector<double>& prices = m_filteredPrices.mutableData();
+        prices.resize(positions.size());
+        for (size_t i = 0; i < positions.size(); ++i) prices[i] = m_prices[positions[i]];
+        m_filteredHistogram.setEdges(m_histogram.edges());
+        m_filteredHistogram.compute(prices.data(), qint64(prices.size()));
+    }
+
+    // 图表节点的样式和数据绑定，都读当前显示的（可能是筛选后的）数据
+    void setupScene() {
+        // 柱状图：按区间着色，放得下时逐项画（斜标签），否则按区间分组分桶
+        m_bars.frame.fill = QColor(30, 30, 50, 200);
+        m_bars.title = [] { return QString("💰 单价对比（元）"); };
+        m_bars.setOverhang(20);     // 斜标签伸出边框底部
+        m_bars.count = [this] { return int(shownPrices().size()); };
+        m_bars.value = [this](int i) { return shownPrices()[i]; };
+        m_bars.band = [this](int i) { return shownHistogram().binOf(i); };
+        m_bars.bandColors = [this](int band) {
+            const int bins = shownHistogram().binCount();
+            return BarChartNode::BandColors{barTopColor(band, bins), barBottomColor(band, bins),
+                                            barBottomColor(band, bins)};
+        };
+        m_bars.bar = [this](int i) {
+            const PriceHistogram& histogram = shownHistogram();
+            const int bin = histogram.binOf(i);
+            BarChartNode::Bar b;
+            b.value = shownPrices()[i];
+            b.stops = {{0, barTopColor(bin, histogram.binCount())}, {1, barBottomColor(bin, histogram.binCount())}};
+            b.valueText = QString::number(b.value, 'f', 2);
+            b.label = itemName(i);
+            return b;
+        };
+        m_bars.emptyText = [this] { return m_search.active() ? QString("没有匹配的耗材") : QString(); };
+
+        // 饼图：各区间计数在数据变化时已算好
+        m_pie.frame.fill = QColor(30, 30, 50, 200);
+        m_pie.title = [] { return QString("📊 价格区间分布"); };
+        m_pie.style.legendOffset = QPoint(pieChartArea().width() - 151, 40);    // 右侧
+        m_pie.count = [this] { return shownHistogram().total() > 0 ? shownHistogram().binCount() : 0; };
+        m_pie.slice = [this](int i) {
+            const PriceHistogram& histogram = shownHistogram();
+            return PieChartNode::Slice{double(histogram.count(i)) / histogram.total(),
+                                       pieColor(i, histogram.binCount())};
+        };
+        m_pie.legendRow = [this](int i) {
+            const PriceHistogram& histogram = shownHistogram();
+            PieChartNode::LegendRow row;
+            row.color = pieColor(i, histogram.binCount());
+            row.text = QString("%1 (%2): %3项")
+                    .arg(bandName(i), histogram.rangeLabel(i, "元"))
+                    .arg(histogram.count(i));
+            return row;
+        };
+
+        // 清单：筛选时标题带匹配数，最高/最低价格区间的单价特殊着色
+        m_table.frame.fill = QColor(30, 30, 50, 220);
+        m_table.frame.titleColor = QColor(100, 200, 255);
+        m_table.title = [this] {
+            QString title = "📋 耗材详细清单";
+            if (m_search.active())
+                title += QString("（匹配 %1 / %2 项）").arg(shownPrices().size()).arg(m_prices.size());
+            return title;
+        };
+        m_table.columns = {
+                {"序号", 60, Qt::AlignLeft | Qt::AlignVCenter},
+                {"器械名称", 400, Qt::AlignLeft | Qt::AlignVCenter},
+                {"规格", 300, Qt::AlignLeft | Qt::AlignVCenter},
+                {"单价（元）", 100, Qt::AlignLeft | Qt::AlignVCenter}
+        };
+        m_table.rowCount = [this] { return qint64(shownPrices().size()); };
+        m_table.cells = [this](qint64 row, std::vector<TableNode::Cell>& cells) {
+            const int i = int(row);
+            const PriceHistogram& histogram = shownHistogram();
+            const int bin = histogram.binOf(i);
+            const int bins = histogram.binCount();
+            const QColor text = i % 2 ? QColor(220, 220, 220) : QColor(240, 240, 240);
+            QColor price = text;
+            if (bins > 1 && bin == bins - 1) price = QColor(255, 120, 120);     // 高价红色
+            else if (bins > 1 && bin == 0) price = QColor(120, 200, 255);       // 低价蓝色
+            cells = {
+                    {QString::number(i + 1), text},
+                    {itemName(i), text},
+                    {itemSpec(i), text},
+                    {"¥" + QString::number(shownPrices()[i], 'f', 2), price, Qt::AlignRight | Qt::AlignVCenter}
+            };
+        };
+
+        // 价格走势：点清单里的行时代替饼图显示
+        m_historyChart.frame.fill = QColor(30, 30, 50, 200);
+        m_historyChart.title = [this] { return QString("📈 %1 价格走势").arg(m_historyName); };
+        m_historyChart.emptyText = [this] {
+            return m_history.empty() ? QString("未导入价格历史（--history）") : QString("该耗材没有价格历史");
+        };
+        m_historyChart.setVisible(false);
+
+        m_scene.add(&m_bars);
+        m_scene.add(&m_pie);
+        m_scene.add(&m_historyChart);
+        m_scene.add(&m_table);
+        m_hover.addTo(m_scene);
+    }
+
+    // 第 i 个显示项的完整信息（柱状图斜标签、清单列宽都会截断名称）；名称放最后替换，不会被当成占位符
+    QString itemTooltip(int i) const {
+        const PriceHistogram& histogram = shownHistogram();
+        const int bin = histogram.binOf(i);
+        return QString("%5\n规格: %6\n单价: ¥%1\n%2 (%3) · 价格第 %4 位")
+                .arg(shownPrices()[i], 0, 'f', 2)
+                .arg(bandName(bin), histogram.rangeLabel(bin, "元"))
+                .arg(i + 1)
+                .arg(itemName(i), itemSpec(i));
+    }
+
+    // 柱状图命中一根柱子时同清单；LOD 时为一个桶：名次范围、价格范围和桶内最贵的一项
+    QString barTooltip(const ChartHit& hit) const {
+        if (hit.first == hit.last) return itemTooltip(hit.first);
+        return QString("第 %1 ~ %2 项（共 %3 项）\n单价: ¥%4 ~ ¥%5\n最高: %6 %7")
+                .arg(hit.first + 1).arg(hit.last + 1).arg(shownPrices().size())
+                .arg(shownPrices()[hit.last], 0, 'f', 2)
+                .arg(shownPrices()[hit.first], 0, 'f', 2)
+                .arg(itemName(hit.first), itemSpec(hit.first));
+    }
+
+    QString bandTooltip(int bin) const {
+        const PriceHistogram& histogram = shownHistogram();
+        return QString("%1 (%2)\n%3 项，占 %4%")
+                .arg(bandName(bin), histogram.rangeLabel(bin, "元"))
+                .arg(histogram.count(bin))
+                .arg(100.0 * histogram.count(bin) / qMax<qint64>(1, histogram.total()), 0, 'f', 1);
+    }
+
+    // 区间颜色：stops 为低/中/高三档，区间数不是 3 时按位置插值
+    static QColor bandColor(const QColor (&stops)[3], int bin, int bins) {
+        if (bins <= 1) return stops[1];
+        double t = 2.0 * bin / (bins - 1);
+        int i = qMin(1, int(t));
+        double f = t - i;
+        const QColor& a = stops[i];
+        const QColor& b = stops[i + 1];
+        return QColor::fromRgbF(a.redF() + (b.redF() - a.redF()) * f,
+                                a.greenF() + (b.greenF() - a.greenF()) * f,
+                                a.blueF() + (b.blueF() - a.blueF()) * f);
+    }
+
+    // 柱子渐变：顶部亮、底部暗
+    static QColor barTopColor(int bin, int bins) {
+        static const QColor stops[3] = {QColor(100, 180, 255), QColor(255, 200, 100), QColor(255, 100, 100)};
+        return bandColor(stops, bin, bins);
+    }
+
+    static QColor barBottomColor(int bin, int bins) {
+        static const QColor stops[3] = {QColor(60, 120, 180), QColor(200, 150, 60), QColor(180, 60, 60)};
+        return bandColor(stops, bin, bins);
+    }
+
+    // 饼图扇形：低价蓝、中价黄、高价红
+    static QColor pieColor(int bin, int bins) {
+        static const QColor stops[3] = {QColor(80, 180, 255), QColor(255, 200, 100), QColor(255, 100, 100)};
+        return bandColor(stops, bin, bins);
+    }
+
+    // 三档时沿用 低价/中价/高价 的叫法
+    QString bandName(int bin) const {
+        static const char* names[] = {"低价", "中价", "高价"};
+        if (m_histogram.binCount() == 3) return names[bin];
+        return QString("区间%1").arg(bin + 1);
+    }
+
+    void drawTitle(QPainter& p) {
+        // 标题背景
+        p.setBrush(QColor(20, 40, 80, 200));
+        p.setPen(QColor(100, 180, 255, 100));
+        p.drawRoundedRect(0, 0, width(), 60, 0, 0);
+
+        // 主标题
+        p.setFont(vizFont(20, QFont::Bold));
+        QLinearGradient titleGrad(0, 0, width(), 0);
+        titleGrad.setColorAt(0, QColor(100, 200, 255));
+        titleGrad.setColorAt(1, QColor(200, 150, 255));
+        p.setPen(QPen(titleGrad, 2));
+        drawCachedText(p, 0, 0, width(), 60, Qt::AlignCenter,
+                   "🏥 医疗耗材数据可视化分析");
+
+        // 副标题
+        p.setFont(vizFont(10));
+        p.setPen(QColor(200, 220, 255));
+        drawCachedText(p, 0, 40, width(), 30, Qt::AlignCenter,
+                   "免责声明:数据均为虚构演示，不涉及任何企业和单位商业机密");
+    }
+};
+
+class MedicalPricingViz : public QWidget {
+public:
+    static constexpr const char* kDefaultBackground = "D:/ad/c/pic/background1.jpg";
+
+    explicit MedicalPricingViz(const QString& backgroundPath = kDefaultBackground, QWidget* parent = nullptr)
+        : QWidget(parent) {
+        setWindowTitle("C++QT可视化图表医疗耗材价格对比 - 输液器测试(作者-冷溪虎山)");
+        resize(1000, 750);
+        setFocusPolicy(Qt::StrongFocus);
+        setMouseTracking(true);     // 不按键也收 mouseMoveEvent，用于悬停提示
+
+        // 名称/规格筛选框：边输入边筛（Ctrl+F 聚焦，Esc 清空）
+        m_filterBox = new QLineEdit(this);
+        m_filterBox->setPlaceholderText("🔍 筛选名称/规格，如: 注射器 1ml");
+        m_filterBox->setClearButtonEnabled(true);
+        m_filterBox->setStyleSheet("QLineEdit { background: rgba(20, 30, 60, 200); color: white;"
+                                   " border: 1px solid rgba(100, 180, 255, 150); border-radius: 6px;"
+                                   " padding: 2px 6px; }");
+        QObject::connect(m_filterBox, &QLineEdit::textChanged, this, [this](const QString& text) {
+            m_dash.setFilter(text);
+            damage(m_dash.dirtyRegion());
+        });
+
+        // 背景图在后台解码，加载完成前先显示渐变背景
+        setBackgroundPath(backgroundPath);
+    }
+
+    MedicalDashboard& dashboard() { return m_dash; }
+
+    // 在线程池里解码背景图，完成后回到 GUI 线程替换；期间保持当前背景
+    void setBackgroundPath(const QString& path) {
+        const quint64 request = ++m_backgroundRequest;
+        if (path.isEmpty()) {
+            m_dash.setBackground(QImage());
+            update();
+            return;
+        }
+
+        QPointer<MedicalPricingViz> self(this);
+        QThreadPool::globalInstance()->start([self, path, request] {
+            QImageReader reader(path);
+            reader.setAutoTransform(true);
+            QImage image = reader.read();
+            QString error = reader.errorString();
+            if (!image.isNull()) image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+            QMetaObject::invokeMethod(qApp, [self, path, request, image, error] {
+                // 窗口已关闭，或者期间又换了背景图
+                if (!self || request != self->m_backgroundRequest) return;
+                if (image.isNull()) {
+                    qDebug() << "背景图未找到！路径:" << path << error;
+                    qDebug() << "将使用渐变背景";
+                    return;
+                }
+                self->m_dash.setBackground(image);
+                self->update();
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    bool loadCatalog(const QString& path) {
+        bool ok = m_dash.loadCatalog(path);
+        update();
+        return ok;
+    }
+
+    bool openSnapshot(const QString& path) {
+        bool ok = m_dash.openSnapshot(path);
+        update();
+        return ok;
+    }
+
+    void setFilter(const QString& query) { m_filterBox->setText(query); }
+
+    bool loadPriceHistory(const QString& path) {
+        bool ok = m_dash.loadPriceHistory(path);
+        damage(m_dash.dirtyRegion());
+        return ok;
+    }
+
+protected:
+    void paintEvent(QPaintEvent* e) override {
+        QPainter p(this);
+        m_dash.render(p, e->rect(), devicePixelRatioF());
+    }
+
+    void wheelEvent(QWheelEvent* e) override {
+        // 走势图内滚轮缩放，每格 1.25 倍
+        const QPoint pos = e->position().toPoint();
+        if (m_dash.historyVisible() && MedicalDashboard::pieChartArea().contains(pos)) {
+            if (m_dash.zoomHistory(std::pow(0.8, e->angleDelta().y() / 120.0), pos.x())) damage(m_dash.dirtyRegion());
+            e->accept();
+            return;
+        }
+
+        // 清单区域内滚轮滚动（每格3行，触控板按像素）；鼠标下换了一行，提示跟着换
+        if (MedicalDashboard::tableArea().contains(pos)) {
+            if (m_dash.scrollTableByWheel(e->pixelDelta(), e->angleDelta())) {
+                m_dash.hover(pos);
+                damage(m_dash.dirtyRegion());
+            }
+            e->accept();
+            return;
+        }
+        QWidget::wheelEvent(e);
+    }
+
+    void mousePressEvent(QMouseEvent* e) override {
+        if (e->button() != Qt::LeftButton) {
+            QWidget::mousePressEvent(e);
+            return;
+        }
+        const QPoint pos = e->pos();
+
+        // 点清单行：在饼图位置显示该耗材的价格走势
+        const int row = m_dash.tableRowAt(pos);
+        if (row >= 0) {
+            m_dash.showHistory(row);
+            damage(m_dash.dirtyRegion());
+            return;
+        }
+
+        // 在走势图上按住拖动平移
+        if (m_dash.historyVisible() && MedicalDashboard::pieChartArea().contains(pos)) m_dragX = pos.x();
+    }
+
+    void mouseMoveEvent(QMouseEvent* e) override {
+        // 拖动走势图时平移，否则做悬停命中
+        if (m_dragX >= 0 && (e->buttons() & Qt::LeftButton)) {
+            if (m_dash.panHistory(e->pos().x() - m_dragX)) damage(m_dash.dirtyRegion());
+            m_dragX = e->pos().x();
+            return;
+        }
+        if (m_dash.hover(e->pos())) damage(m_dash.dirtyRegion());
+    }
+
+    void leaveEvent(QEvent* e) override {
+        m_dash.clearHover();
+        damage(m_dash.dirtyRegion());
+        QWidget::leaveEvent(e);
+    }
+
+    void mouseReleaseEvent(QMouseEvent* e) override {
+        m_dragX = -1;
+        QWidget::mouseReleaseEvent(e);
+    }
+
+    void keyPressEvent(QKeyEvent* e) override {
+        switch (e->key()) {
+            case Qt::Key_H:     // 走势图切回饼图
+                if (m_dash.historyVisible()) {
+                    m_dash.hideHistory();
+                    damage(m_dash.dirtyRegion());
+                }
+                break;
+            case Qt::Key_Home:  // 走势图回到全程
+                m_dash.resetHistoryZoom();
+                damage(m_dash.dirtyRegion());
+                break;
+            case Qt::Key_F12:   // 开关绘制计时 HUD
+                m_dash.profiler().setEnabled(!m_dash.profiler().enabled());
+                m_dash.profiler().clear();
+                update();
+                break;
+            case Qt::Key_F11: { // 导出 Chrome trace
+                QString path = QString("paint_trace_%1.json")
+                        .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+                qDebug() << "导出绘制trace:" << path << m_dash.profiler().exportChromeTrace(path);
+                break;
+            }
+            case Qt::Key_F:     // Ctrl+F 聚焦筛选框
+                if (e->modifiers() & Qt::ControlModifier) {
+                    m_filterBox->setFocus();
+                    m_filterBox->selectAll();
+                } else {
+                    QWidget::keyPressEvent(e);
+                }
+                break;
+            case Qt::Key_Escape:    // 筛选框不处理 Esc，会传到这里
+                m_filterBox->clear();
+                break;
+            default:
+                QWidget::keyPressEvent(e);
+        }
+    }
+
+    void resizeEvent(QResizeEvent* e) override {
+        m_dash.setSize(size());
+        m_filterBox->setGeometry(width() - 250, 16, 230, 28);    // 标题栏右侧
+        QWidget::resizeEvent(e);
+    }
+
+private:
+    MedicalDashboard m_dash;
+    QLineEdit* m_filterBox = nullptr;
+    quint64 m_backgroundRequest = 0;    // 只采用最近一次 setBackgroundPath 的结果
+    int m_dragX = -1;                   // 拖动走势图时上一次的鼠标 x，-1 表示没在拖
+
+    // 局部重绘；HUD 打开时顺带刷新 HUD 区域
+    void damage(QRegion region) {
+        if (m_dash.profiler().enabled()) region += PaintProfiler::hudRect(MedicalDashboard::hudOrigin());
+        update(region);
+    }
+};
@@ -0,0 +1,194 @@
+#pragma once
+
+// 金额定点数：64 位整数，单位为分
+//
+// 合计、占比都在整数上算，千万条流水求和没有浮点舍入漂移，加法顺序（分块、多线程）不影响结果，
+// 与对账逐分一致。解析直接把 "1234.56" 读成 123456 分，不经过 double；显示时按元/万元在整数上
+// 四舍五入格式化。只有画图要算像素坐标时才转成 double。
+//
+// 求和与分组求和的内层循环是纯整数加法（多路独立累加，编译器可自动向量化），大数组按块分给
+// 多个线程，瓶颈在内存带宽，不再受浮点加法延迟链限制。
+
+#include <QString>
+#include <QThread>
+#include <QtGlobal>
+#include <thread>
+#include <vector>
+
+class Money {
+public:
+    static constexpr qint64 kFenPerYuan = 100;
+    static constexpr qint64 kFenPerWan = 1000000;       // 1 万元
+
+    constexpr Money() = default;
+
+    static constexpr Money fromFen(qint64 fen) { return Money(fen); }
+    // 录入常量、图表坐标反算时用；四舍五入到分
+    static Money fromYuan(double yuan) { return Money(qRound64(yuan * kFenPerYuan)); }
+    static Money fromWan(double wan) { return Money(qRound64(wan * kFenPerWan)); }
+
+    constexpr qint64 fen() const { return m_fen; }
+    // 只用于算像素坐标，不参与合计
+    double toYuan() const { return double(m_fen) / kFenPerYuan; }
+    double toWan() const { return double(m_fen) / kFenPerWan; }
+
+    constexpr bool isZero() const { return m_fen == 0; }
+
+    // 占 total 的比例（0~1），total 为 0 时返回 0
+    double ratio(Money total) const { return total.m_fen != 0 ? double(m_fen) / double(total.m_fen) : 0; }
+
+    Money& operator+=(Money o) { m_fen += o.m_fen; return *this; }
+    Money& operator-=(Money o) { m_fen -= o.m_fen; return *this; }
+    friend constexpr Money operator+(Money a, Money b) { return Money(a.m_fen + b.m_fen); }
+    friend constexpr Money operator-(Money a, Money b) { return Money(a.m_fen - b.m_fen); }
+    friend constexpr Money operator-(Money a) { return Money(-a.m_fen); }
+    friend constexpr bool operator==(Money a, Money b) { return a.m_fen == b.m_fen; }
+    friend constexpr bool operator!=(Money a, Money b) { return a.m_fen != b.m_fen; }
+    friend constexpr bool operator<(Money a, Money b) { return a.m_fen < b.m_fen; }
+    friend constexpr bool operator>(Money a, Money b) { return a.m_fen > b.m_fen; }
+    friend constexpr bool operator<=(Money a, Money b) { return a.m_fen <= b.m_fen; }
+    friend constexpr bool operator>=(Money a, Money b) { return a.m_fen >= b.m_fen; }
+
+    // 以 unitFen 分为单位（100 = 元，kFenPerWan = 万元）保留 decimals 位，整数四舍五入（远离 0）
+    QString format(qint64 unitFen, int decimals) const {
+        qint64 scale = unitFen;
+        qint64 pow10 = 1;
+        int places = 0;
+        for (; places < decimals && scale % 10 == 0; ++places) {    // 小数位不超过分
+            scale /= 10;
+            pow10 *= 10;
+        }
+        const quint64 magnitude = m_fen < 0 ? quint64(0) - quint64(m_fen) : quint64(m_fen);
+        const quint64 q = (magnitude + quint64(scale) / 2) / quint64(scale);
+
+        QString s;
+        if (m_fen < 0 && q != 0) s += QLatin1Char('-');
+        s += QString::number(q / quint64(pow10));
+        if (places > 0) {
+            s += QLatin1Char('.');
+            s += QString::number(q % quint64(pow10)).rightJustified(places, QLatin1Char('0'));
+        }
+        return s;
+    }
+
+    QString toYuanString() const { return format(kFenPerYuan, 2); }
+    QString toWanString(int decimals = 1) const { return format(kFenPerWan, decimals); }
+
+    // 解析十进制金额（元），前后空格可选；第三位小数起按四舍五入（远离 0）进到分。
+    // 手写解析，不经过 double、不受 locale 影响，结果精确
+    static bool parse(const char* p, const char* end, Money& out) {
+        while (p < end && *p == ' ') ++p;
+        while (end > p && (end[-1] == ' ' || end[-1] == '\r' || end[-1] == '\n')) --end;
+
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+
+        qint64 yuan = 0;
+        int digits = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p, ++digits) {
+            if (digits >= 16) return false;     // 超出 qint64 分的安全范围
+            yuan = yuan * 10 + (*p - '0');
+        }
+        qint64 fen = 0;
+        if (p < end && *p == '.') {
+            int decimals = 0;
+            for (++p; p < end && *p >= '0' && *p <= '9'; ++p, ++decimals, ++digits) {
+                if (decimals < 2) fen = fen * 10 + (*p - '0');
+                else if (decimals == 2 && *p >= '5') fen += 1;    // 第三位四舍五入，之后的位忽略
+            }
+            if (decimals == 1) fen *= 10;
+        }
+        if (digits == 0 || p != end) return false;
+
+        const qint64 total = yuan * kFenPerYuan + fen;
+        out = Money(negative ? -total : total);
+        return true;
+    }
+
+    // ---- 批量聚合（输入为分） ----
+
+    // 求和；4 路独立累加，编译器可向量化
+    static qint64 sumFen(const qint64* fen, qint64 n, int threads = QThread::idealThreadCount()) {
+        return parallelChunks(n, threads, [fen](qint64 begin, qint64 end) {
+            qint64 a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+            qint64 i = begin;
+            for (; i + 4 <= end; i += 4) {
+                a0 += fen[i];
+                a1 += fen[i + 1];
+                a2 += fen[i + 2];
+                a3 += fen[i + 3];
+            }
+            for (; i < end; ++i) a0 += fen[i];
+            return (a0 + a1) + (a2 + a3);
+        });
+    }
+
+    // 按组求和：out[group[i]] += fen[i]（out 长 groupCount，调用方清零或累加到已有结果）；
+    // 越界的组号跳过，返回跳过的条数。每个线程先累加到私有数组，最后按列合并
+    static qint64 groupSumFen(const quint32* group, const qint64* fen, qint64 n,
+                              qint64* out, int groupCount, int threads = QThread::idealThreadCount()) {
+        const int chunks = chunkCount(n, threads);
+        std::vector<std::vector<qint64>> partial(size_t(chunks - 1), std::vector<qint64>(size_t(groupCount), 0));
+        std::vector<qint64> skipped(size_t(chunks), 0);
+        auto work = [&](int c) {
+            qint64* acc = c == 0 ? out : partial[size_t(c - 1)].data();
+            const quint32 limit = quint32(groupCount);
+            qint64 bad = 0;
+            for (qint64 i = n * c / chunks, end = n * (c + 1) / chunks; i < end; ++i) {
+                const quint32 g = group[i];
+                if (g < limit) acc[g] += fen[i];
+                else ++bad;
+            }
+            skipped[size_t(c)] = bad;
+        };
+        run(chunks, work);
+
+        qint64 bad = skipped[0];
+        for (int c = 1; c < chunks; ++c) {
+            addFen(out, partial[size_t(c - 1)].data(), groupCount);
+            bad += skipped[size_t(c)];
+        }
+        return bad;
+    }
+
+    // dst[i] += src[i]，合并各线程的分组结果
+    static void addFen(qint64* dst, const qint64* src, qint64 n) {
+        for (qint64 i = 0; i < n; ++i) dst[i] += src[i];
+    }
+
+private:
+    static constexpr qint64 kParallelThreshold = 1 << 18;   // 小数组不值得开线程
+
+    qint64 m_fen = 0;
+
+    constexpr explicit Money(qint64 fen) : m_fen(fen) {}
+
+    static int chunkCount(qint64 n, int threads) {
+        return n < kParallelThreshold ? 1 : int(qBound<qint64>(1, threads, n / kParallelThreshold));
+    }
+
+    template <typename Work>
+    static void run(int chunks, Work& work) {
+        if (chunks == 1) {
+            work(0);
+            return;
+        }
+        std::vector<std::thread> pool;
+        pool.reserve(size_t(chunks - 1));
+        for (int c = 1; c < chunks; ++c) pool.emplace_back([&work, c] { work(c); });
+        work(0);
+        for (std::thread& t : pool) t.join();
+    }
+
+    // 把 [0, n) 分块交给 f(begin, end)，各块结果相加（整数加法，与分块方式无关）
+    template <typename F>
+    static qint64 parallelChunks(qint64 n, int threads, F f) {
+        const int chunks = chunkCount(n, threads);
+        std::vector<qint64> sums(size_t(chunks), 0);
+        auto work = [&](int c) { sums[size_t(c)] = f(n * c / chunks, n * (c + 1) / chunks); };
+        run(chunks, work);
+        qint64 total = 0;
+        for (qint64 s : sums) total += s;
+        return total;
+    }
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+// 字符串池上的 n-gram 倒排索引
+//
+// 每个字符串按大小写折叠后的单字和相邻双字(bigram)登记，倒排表里是升序的字符串 id。
+// 中文一个字基本就是一个语素，双字已经有足够的区分度；英文/数字规格片段区分度低，
+// 所以多于两个字的词求完交集后再逐个做子串核对，结果是精确的。
+// 索引建在去重后的字符串上而不是行上，重复的名称/规格只登记一次。
+
+#include <QHash>
+#include <QStringView>
+#include <QVarLengthArray>
+#include <QtGlobal>
+#include <algorithm>
+#include <vector>
+#include "string_pool.h"
+
+class NgramIndex {
+public:
+    void clear() {
+        m_slots.clear();
+        m_postings.clear();
+        m_strings = nullptr;
+    }
+
+    // 索引引用 pool 做核对，pool 须比索引活得久且不再变化
+    void build(const StringPool& pool) {
+        clear();
+        m_strings = &pool;
+        for (quint32 id = 0; id < quint32(pool.size()); ++id) {
+            QStringView s = pool.view(id);
+            quint32 prev = 0;
+            for (QChar c : s) {
+                const quint32 cur = fold(c);
+                add(cur, id);
+                if (prev) add(bigram(prev, cur), id);
+                prev = cur;
+            }
+        }
+    }
+
+    bool empty() const { return m_strings == nullptr; }
+
+    // 包含 token 的字符串 id（升序，不区分大小写）。
+    // within 非空时只在这些 id 里找：新词包含旧词时传上一次的结果，只会更快地缩小。
+    std::vector<quint32> match(QStringView token, const std::vector<quint32>* within = nullptr) const {
+        std::vector<quint32> out;
+        if (token.isEmpty() || empty()) return out;
+
+        QVarLengthArray<const std::vector<quint32>*, 16> lists;
+        if (token.size() == 1) {
+            lists.append(posting(fold(token[0])));
+        } else {
+            for (qsizetype i = 0; i + 1 < token.size(); ++i)
+                lists.append(posting(bigram(fold(token[i]), fold(token[i + 1]))));
+        }
+        if (within) lists.append(within);
+        for (const std::vector<quint32>* list : lists)
+            if (!list || list->empty()) return out;
+
+        // 从最短的表开始求交集
+        std::sort(lists.begin(), lists.end(), [](const std::vector<quint32>* a, const std::vector<quint32>* b) {
+            return a->size() < b->size();
+        });
+        out = *lists[0];
+        for (int i = 1; i < lists.size() && !out.empty(); ++i) intersect(out, *lists[i]);
+
+        // 双字都出现不代表连续出现
+        if (token.size() > 2) {
+            const Qt::CaseSensitivity cs = hasCase(token) ? Qt::CaseInsensitive : Qt::CaseSensitive;
+            out.erase(std::remove_if(out.begin(), out.end(), [&](quint32 id) {
+                return !m_strings->view(id).contains(token, cs);
+            }), out.end());
+        }
+        return out;
+    }
+
+    qint64 memoryBytes() const {
+        qint64 bytes = qint64(m_postings.capacity() * sizeof(std::vector<quint32>))
+                       + qint64(m_slots.capacity()) * qint64(2 * sizeof(quint32) + 2 * sizeof(void*));
+        for (const std::vector<quint32>& list : m_postings) bytes += qint64(list.capacity() * sizeof(quint32));
+        return bytes;
+    }
+
+private:
+    QHash<quint32, int> m_slots;                    // gram -> m_postings 下标
+    std::vector<std::vector<quint32>> m_postings;
+    const StringPool* m_strings = nullptr;
+
+    // 单字键即 UTF-16 码元本身，双字键高 16 位放前一个字（不会为 0）
+    static quint32 fold(QChar c) { return c.toCaseFolded().unicode(); }
+    static quint32 bigram(quint32 a, quint32 b) { return (a << 16) | b; }
+
+    // 纯中文/数字的词区分大小写匹配更快，结果一样
+    static bool hasCase(QStringView s) {
+        return std::any_of(s.begin(), s.end(), [](QChar c) { return c.toUpper() != c || c.toLower() != c; });
+    }
+
+    void add(quint32 key, quint32 id) {
+        auto it = m_slots.find(key);
+        if (it == m_slots.end()) {
+            it = m_slots.insert(key, int(m_postings.size()));
+            m_postings.emplace_back();
+        }
+        // id 递增登记，同一字符串里重复的 gram 只记一次
+        std::vector<quint32>& list = m_postings[size_t(it.value())];
+        if (list.empty() || list.back() != id) list.push_back(id);
+    }
+
+    const std::vector<quint32>* posting(quint32 key) const {
+        auto it = m_slots.constFind(key);
+        return it == m_slots.constEnd() ? nullptr : &m_postings[size_t(it.value())];
+    }
+
+    // a ∩= b；b 远长于 a 时逐个二分查找，否则线性归并
+    static void intersect(std::vector<quint32>& a, const std::vector<quint32>& b) {
+        auto keep = a.begin();
+        if (b.size() > a.size() * 16) {
+            auto from = b.begin();
+            for (quint32 id : a) {
+                from = std::lower_bound(from, b.end(), id);
+                if (from == b.end()) break;
+                if (*from == id) *keep++ = id;
+            }
+        } else {
+            auto ia = a.begin();
+            auto ib = b.begin();
+            while (ia != a.end() && ib != b.end()) {
+                if (*ia < *ib) {
+                    ++ia;
+                } else if (*ib < *ia) {
+                    ++ib;
+                } else {
+                    *keep++ = *ia;
+                    ++ia;
+                    ++ib;
+                }
+            }
+        }
+        a.erase(keep, a.end());
+    }
+};
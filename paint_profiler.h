@@ -0,0 +1,204 @@
+#pragma once
+
+// 绘制阶段计时
+//
+// PAINT_SCOPE(profiler, "阶段名") 在作用域结束时把耗时写入固定大小的环形缓冲。
+// 关闭时只有一次布尔判断；定义 VIZ_NO_PROFILER 则完全编译掉。
+// 支持屏幕 HUD（各阶段 p50/p99 + 帧时间）和导出 Chrome trace_event JSON（可用 Perfetto 打开）。
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QString>
+#include <QVector>
+#include <algorithm>
+#include <array>
+
+class PaintProfiler {
+public:
+    static constexpr int kCapacity = 8192;       // 环形缓冲条数
+    static constexpr const char* kFrame = "frame";
+
+    struct Event {
+        const char* stage;    // 必须是字符串字面量
+        qint64 startNs;
+        qint64 durationNs;
+        quint32 frame;
+    };
+
+    struct Stats {
+        const char* stage;
+        int samples;
+        double p50Ms;
+        double p99Ms;
+    };
+
+    bool enabled() const { return m_enabled; }
+    void setEnabled(bool on) { m_enabled = on; }
+
+    static qint64 now() { return clock().nsecsElapsed(); }
+
+    void beginFrame() {
+        if (!m_enabled) return;
+        ++m_frame;
+        m_frameStart = now();
+    }
+
+    void endFrame() {
+        if (!m_enabled) return;
+        record(kFrame, m_frameStart, now() - m_frameStart);
+    }
+
+    void record(const char* stage, qint64 startNs, qint64 durationNs) {
+        m_events[m_next] = {stage, startNs, durationNs, m_frame};
+        m_next = (m_next + 1) % kCapacity;
+        if (m_count < kCapacity) ++m_count;
+    }
+
+    void clear() { m_count = 0; m_next = 0; }
+
+    // 按首次出现顺序统计各阶段，帧时间排在最后
+    QVector<Stats> stats() const {
+        QVector<const char*> stages;
+        forEachEvent([&stages](const Event& e) {
+            if (e.stage != kFrame && !stages.contains(e.stage)) stages.append(e.stage);
+        });
+        stages.append(kFrame);
+
+        QVector<Stats> result;
+        QVector<qint64> samples;
+        for (const char* stage : stages) {
+            samples.resize(0);
+            forEachEvent([&](const Event& e) {
+                if (e.stage == stage) samples.append(e.durationNs);
+            });
+            result.append({stage, samples.size(), percentile(samples, 0.50) / 1e6, percentile(samples, 0.99) / 1e6});
+        }
+        return result;
+    }
+
+    // HUD 占用区域（按最多 12 行估算），局部重绘时一并刷新
+    static QRect hudRect(const QPoint& topLeft) { return QRect(topLeft, QSize(260, 24 + 16 * 12)); }
+
+    // 左上角半透明面板
+    void drawHud(QPainter& p, const QPoint& topLeft) const {
+        QVector<Stats> rows = stats();
+        const int lineH = 16;
+        QRect box(topLeft, QSize(260, 24 + lineH * rows.size()));
+
+        p.save();
+        p.setRenderHint(QPainter::Antialiasing, false);
+        p.setPen(Qt::NoPen);
+        p.setBrush(QColor(0, 0, 0, 170));
+        p.drawRect(box);
+
+        QFont font("Consolas", 9);
+        font.setStyleHint(QFont::Monospace);
+        p.setFont(font);
+        p.setPen(QColor(120, 255, 160));
+        p.drawText(box.adjusted(8, 4, -8, 0), Qt::AlignLeft | Qt::AlignTop,
+                   QString("%1 %2 %3").arg("阶段", -14).arg("p50(ms)", 8).arg("p99(ms)", 8));
+
+        int y = box.top() + 4 + lineH;
+        for (const Stats& s : rows) {
+            p.setPen(s.stage == kFrame ? QColor(255, 220, 120) : QColor(230, 230, 230));
+            p.drawText(box.left() + 8, y, box.width() - 16, lineH, Qt::AlignLeft | Qt::AlignVCenter,
+                       QString("%1 %2 %3")
+                               .arg(QString::fromUtf8(s.stage), -14)
+                               .arg(s.p50Ms, 8, 'f', 3)
+                               .arg(s.p99Ms, 8, 'f', 3));
+            y += lineH;
+        }
+        p.restore();
+    }
+
+    // Chrome trace_event 格式（"X" 完整事件，时间单位微秒）
+    bool exportChromeTrace(const QString& path) const {
+        QJsonArray events;
+        forEachEvent([&events](const Event& e) {
+            events.append(QJsonObject{
+                    {"name", QString::fromUtf8(e.stage)},
+                    {"cat", "paint"},
+                    {"ph", "X"},
+                    {"ts", e.startNs / 1000.0},
+                    {"dur", e.durationNs / 1000.0},
+                    {"pid", int(QCoreApplication::applicationPid())},
+                    {"tid", 1},
+                    {"args", QJsonObject{{"frame", int(e.frame)}}}});
+        });
+
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) return false;
+        file.write(QJsonDocument(QJsonObject{{"traceEvents", events},
+                                             {"displayTimeUnit", "ms"}}).toJson(QJsonDocument::Compact));
+        return true;
+    }
+
+private:
+    bool m_enabled = false;
+    quint32 m_frame = 0;
+    qint64 m_frameStart = 0;
+    std::array<Event, kCapacity> m_events{};
+    int m_next = 0;
+    int m_count = 0;
+
+    // 进程级单调时钟，所有 profiler 共用同一时间基准
+    static const QElapsedTimer& clock() {
+        static const QElapsedTimer timer = [] {
+            QElapsedTimer t;
+            t.start();
+            return t;
+        }();
+        return timer;
+    }
+
+    template <typename F>
+    void forEachEvent(F f) const {
+        int first = (m_next - m_count + kCapacity) % kCapacity;
+        for (int i = 0; i < m_count; ++i) f(m_events[(first + i) % kCapacity]);
+    }
+
+    static double percentile(QVector<qint64>& v, double q) {
+        if (v.isEmpty()) return 0;
+        int k = qMin(v.size() - 1, int(q * v.size()));
+        std::nth_element(v.begin(), v.begin() + k, v.end());
+        return double(v[k]);
+    }
+};
+
+class PaintScope {
+public:
+    PaintScope(PaintProfiler& profiler, const char* stage)
+        : m_profiler(profiler.enabled() ? &profiler : nullptr), m_stage(stage),
+          m_start(m_profiler ? PaintProfiler::now() : 0) {}
+
+    // profiler 为空表示不计时（例如分块渲染的工作线程）
+    PaintScope(PaintProfiler* profiler, const char* stage)
+        : m_profiler(profiler && profiler->enabled() ? profiler : nullptr), m_stage(stage),
+          m_start(m_profiler ? PaintProfiler::now() : 0) {}
+
+    ~PaintScope() {
+        if (m_profiler) m_profiler->record(m_stage, m_start, PaintProfiler::now() - m_start);
+    }
+
+    PaintScope(const PaintScope&) = delete;
+    PaintScope& operator=(const PaintScope&) = delete;
+
+private:
+    PaintProfiler* m_profiler;
+    const char* m_stage;
+    qint64 m_start;
+};
+
+#define VIZ_CONCAT_INNER(a, b) a##b
+#define VIZ_CONCAT(a, b) VIZ_CONCAT_INNER(a, b)
+
+#ifdef VIZ_NO_PROFILER
+#define PAINT_SCOPE(profiler, stage) do {} while (0)
+#else
+#define PAINT_SCOPE(profiler, stage) PaintScope VIZ_CONCAT(paintScope_, __LINE__)(profiler, stage)
+#endif
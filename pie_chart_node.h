@@ -0,0 +1,230 @@
+#pragma once
+
+// 饼图 / 环形图节点（带图例）
+//
+// 扇形的起止角、画刷（纯色或锥形渐变）、百分比文字和位置、图例行都在重建时算好，
+// 绘制时只按缓存依次画阴影、扇形、百分比、内圆和图例。
+// 扇形按起始角从 0 递增排列，重建时登记角度区间，悬停命中在这列角度上二分。
+
+#include <QConicalGradient>
+#include <QPainterPath>
+#include <QtMath>
+#include <cmath>
+#include <vector>
+#include "chart_scene.h"
+#include "hit_index.h"
+
+class PieChartNode : public ChartNode {
+public:
+    struct Slice {
+        double fraction = 0;        // 占比 0~1
+        QColor color;
+    };
+
+    struct LegendRow {
+        QColor color;
+        QString text;
+        QString badge;              // 文字右侧的小标记（如趋势箭头）
+        QColor badgeColor;
+    };
+
+    struct Style {
+        int centerX = -1;           // 圆心离边框左侧多远，<0 时水平居中
+        int radius = 0;             // 0 时取 min(宽, 高) / 3 - 20
+        int shadowOffset = 3;
+        int shadowAlpha = 100;
+        bool gradientSlices = false;    // 锥形渐变（亮-原色-暗），否则纯色
+        bool sorted = false;        // 扇形按占比降序：遇到不足 1° 的即可停止
+        int labelMinSpan = 30;      // 超过这个角度的扇形才标百分比
+        double labelRadius = 0.6;
+        int labelWidth = 40;
+        int labelDecimals = 0;
+        double holeRatio = 0;       // 环形图内径 / 外径，0 为实心饼图
+        QColor holeColor;
+        QString centerText;
+        QPoint legendOffset;        // 图例左上角，相对边框左上角
+        int legendTextOffset = 20;
+        int legendTextWidth = 140;
+        int legendBadgeOffset = 0;
+        int legendRowHeight = 25;
+        QColor legendTextColor = Qt::white;
+        QColor swatchPen = Qt::white;
+    };
+
+    Style style;
+
+    // 数据绑定
+    std::function<int()> count;
+    std::function<Slice(int)> slice;
+    std::function<LegendRow(int)> legendRow;        // 只对放得下的前几行调用
+
+    using ChartNode::ChartNode;
+
+    // 鼠标命中的扇形（环形图不含内圆）；不足 1° 没画出来的项不命中
+    ChartHit hitTest(const QPoint& pos) const {
+        if (!isVisible() || m_slices.empty()) return {};
+        const double dx = pos.x() - m_center.x();
+        const double dy = m_center.y() - pos.y();       // 角度逆时针为正
+        const double r2 = dx * dx + dy * dy;
+        const int hole = int(m_radius * style.holeRatio);
+        if (r2 > double(m_radius) * m_radius || r2 < double(hole) * hole) return {};
+
+        double angle = qRadiansToDegrees(std::atan2(dy, dx));
+        if (angle < 0) angle += 360;
+        const int slot = m_hits.find(angle);
+        if (slot < 0) return {};
+        const int item = m_slices[size_t(slot)].item;
+        return {item, item, slot};
+    }
+
+    // 命中扇形的高亮轮廓，比扇形外扩几像素
+    QPainterPath hitShape(const ChartHit& hit) const {
+        QPainterPath path;
+        if (hit.slot < 0 || hit.slot >= int(m_slices.size())) return path;
+        const CachedSlice& s = m_slices[size_t(hit.slot)];
+        const QRectF outer = QRectF(m_pieRect).adjusted(-4, -4, 4, 4);
+        const int hole = int(m_radius * style.holeRatio);
+        const QRectF inner(m_center.x() - hole, m_center.y() - hole, hole * 2, hole * 2);   // 实心饼图退化为圆心
+        path.arcMoveTo(outer, s.start);
+        path.arcTo(outer, s.start, s.span);
+        path.arcTo(inner, s.start + s.span, -s.span);
+        path.closeSubpath();
+        return path;
+    }
+
+    void paint(QPainter& p) const override {
+        paintFrame(p);
+        if (m_slices.empty()) return;
+
+        // 先画阴影层
+        p.setPen(Qt::NoPen);
+        p.setBrush(QColor(0, 0, 0, style.shadowAlpha));
+        const QRect shadow = m_pieRect.translated(style.shadowOffset, style.shadowOffset);
+        for (const CachedSlice& s : m_slices) p.drawPie(shadow, s.start * 16, s.span * 16);
+
+        p.setPen(vizPen(Qt::white, 1));
+        for (const CachedSlice& s : m_slices) {
+            p.setBrush(s.brush);
+            p.drawPie(m_pieRect, s.start * 16, s.span * 16);
+        }
+
+        // 扇形中间的百分比
+        p.setPen(Qt::white);
+        p.setFont(vizFont(10, QFont::Bold));
+        for (const CachedSlice& s : m_slices) {
+            if (s.label.isEmpty()) continue;
+            drawCachedText(p, s.labelPos.x() - style.labelWidth / 2, s.labelPos.y() - 10, style.labelWidth, 20,
+                           Qt::AlignCenter, s.label);
+        }
+
+        // 中间的圆（挖空效果）
+        const QPoint& c = m_center;
+        if (style.holeRatio > 0) {
+            const int hole = int(m_radius * style.holeRatio);
+            p.setBrush(style.holeColor);
+            p.setPen(Qt::NoPen);
+            p.drawEllipse(c.x() - hole, c.y() - hole, hole * 2, hole * 2);
+        }
+
+        // 图例
+        const int x = bounds().left() + style.legendOffset.x();
+        int y = bounds().top() + style.legendOffset.y();
+        for (const LegendRow& row : m_legend) {
+            p.setBrush(row.color);
+            p.setPen(style.swatchPen);
+            p.drawRect(x, y, 15, 15);
+
+            p.setPen(style.legendTextColor);
+            p.setFont(vizFont(10));
+            drawCachedText(p, x + style.legendTextOffset, y, style.legendTextWidth, 15,
+                           Qt::AlignLeft | Qt::AlignVCenter, row.text);
+
+            if (!row.badge.isEmpty()) {
+                p.setPen(row.badgeColor);
+                p.setFont(vizFont(11, QFont::Bold));
+                drawCachedText(p, x + style.legendBadgeOffset, y, 20, 15, Qt::AlignCenter, row.badge);
+            }
+            y += style.legendRowHeight;
+        }
+
+        // 中心标题
+        if (!style.centerText.isEmpty()) {
+            p.setPen(QColor(200, 220, 255));
+            p.setFont(vizFont(11, QFont::Bold));
+            drawCachedText(p, c.x() - 40, c.y() - 5, 80, 20, Qt::AlignCenter, style.centerText);
+        }
+    }
+
+protected:
+    void rebuild() override {
+        const QRect& a = bounds();
+        const int cx = style.centerX < 0 ? a.center().x() : a.left() + style.centerX;
+        const int cy = a.center().y();
+        m_center = QPoint(cx, cy);
+        m_radius = style.radius > 0 ? style.radius : qMin(a.width(), a.height()) / 3 - 20;
+        m_pieRect = QRect(cx - m_radius, cy - m_radius, m_radius * 2, m_radius * 2);
+
+        m_slices.clear();
+        m_legend.clear();
+        m_hits.clear();
+        const int n = count ? count() : 0;
+
+        int startAngle = 0;
+        for (int i = 0; i < n; ++i) {
+            const Slice s = slice(i);
+            const int spanAngle = int(360 * s.fraction);
+            if (spanAngle <= 0) {
+                if (style.sorted) break;    // 之后的扇形都不足 1 度
+                continue;
+            }
+
+            CachedSlice c;
+            c.item = i;
+            c.start = startAngle;
+            c.span = spanAngle;
+            if (style.gradientSlices) {
+                QConicalGradient conicGrad(cx, cy, -startAngle - spanAngle / 2);
+                conicGrad.setColorAt(0.0, s.color.lighter(150));
+                conicGrad.setColorAt(0.5, s.color);
+                conicGrad.setColorAt(1.0, s.color.darker(150));
+                c.brush = QBrush(conicGrad);
+            } else {
+                c.brush = QBrush(s.color);
+            }
+
+            if (spanAngle > style.labelMinSpan) {
+                const double rad = (startAngle + spanAngle / 2.0) * 3.14159 / 180.0;
+                c.labelPos = QPoint(int(cx + m_radius * style.labelRadius * std::cos(rad)),
+                                    int(cy - m_radius * style.labelRadius * std::sin(rad)));
+                c.label = QString::number(s.fraction * 100, 'f', style.labelDecimals) + "%";
+            }
+            m_hits.add(startAngle, startAngle + spanAngle, int(m_slices.size()));
+            m_slices.push_back(std::move(c));
+            startAngle += spanAngle;
+        }
+
+        // 只取放得下的前几行
+        if (m_slices.empty()) return;
+        for (int i = 0, y = a.top() + style.legendOffset.y(); i < n && y + 15 <= a.bottom();
+             ++i, y += style.legendRowHeight) {
+            m_legend.push_back(legendRow(i));
+        }
+    }
+
+private:
+    struct CachedSlice {
+        int item = 0;           // 数据项序号（跳过的项不占位）
+        int start = 0;          // 度
+        int span = 0;
+        QBrush brush;
+        QString label;          // 空串表示扇形太小不标
+        QPoint labelPos;
+    };
+
+    QPoint m_center;
+    QRect m_pieRect;
+    int m_radius = 0;
+    std::vector<CachedSlice> m_slices;
+    std::vector<LegendRow> m_legend;
+    SpanIndex m_hits;           // 各扇形的角度区间
+};
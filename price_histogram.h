@@ -0,0 +1,158 @@
+#pragma once
+
+// 价格区间直方图
+//
+// 对连续存放的价格列按 k 条升序边界分成 k+1 个区间，区间为左闭右开 [e(i-1), e(i))。
+// 一次遍历同时得到每项所在区间和各区间计数，数据变化时计算一次，柱色/饼图/表格共用。
+// 内层循环是"比较 -> 掩码累加"的无分支形式，编译器可自动向量化；大数组按块分给多个线程。
+
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QtGlobal>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "snapshot.h"
+
+class PriceHistogram {
+public:
+    static constexpr int kMaxBins = 255;    // 区间号存成 quint8
+
+    // 升序边界；k 条边界对应 k+1 个区间
+    void setEdges(QVector<double> edges) {
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        if (edges.size() > kMaxBins - 1) edges.resize(kMaxBins - 1);
+        m_edges = edges;
+        m_bins.clear();
+        m_counts.assign(size_t(binCount()), 0);
+    }
+
+    const QVector<double>& edges() const { return m_edges; }
+    int binCount() const { return m_edges.size() + 1; }
+
+    // 计算每项区间号和各区间计数
+    template <typename T>
+    void compute(const T* values, qint64 n, int threads = QThread::idealThreadCount()) {
+        const int edgeCount = m_edges.size();
+        m_bins.mutableData().resize(size_t(n));
+        quint8* const out = m_bins.mutableData().data();
+        m_counts.assign(size_t(binCount()), 0);
+        if (n <= 0) return;
+
+        // 小数组不值得开线程
+        int chunks = n < kParallelThreshold ? 1 : int(qBound<qint64>(1, threads, n / kParallelThreshold));
+        std::vector<qint64> atLeast(size_t(chunks) * edgeCount, 0);     // 每块中 >= 各边界的项数
+
+        auto work = [&](int c) {
+            const qint64 begin = n * c / chunks;
+            const qint64 end = n * (c + 1) / chunks;
+            quint8* bins = out;
+            qint64* ge = atLeast.data() + size_t(c) * edgeCount;
+
+            // 分成能放进 L1 的小块，每条边界扫一遍小块
+            for (qint64 b = begin; b < end; b += kBlock) {
+                const qint64 e = qMin(end, b + kBlock);
+                std::fill(bins + b, bins + e, quint8(0));
+                for (int k = 0; k < edgeCount; ++k) {
+                    const T edge = T(m_edges[k]);
+                    qint64 count = 0;
+                    for (qint64 i = b; i < e; ++i) {
+                        const quint8 hit = values[i] >= edge;
+                        bins[i] += hit;
+                        count += hit;
+                    }
+                    ge[k] += count;
+                }
+            }
+        };
+
+        if (chunks == 1) {
+            work(0);
+        } else {
+            std::vector<std::thread> pool;
+            pool.reserve(chunks - 1);
+            for (int c = 1; c < chunks; ++c) pool.emplace_back(work, c);
+            work(0);
+            for (std::thread& t : pool) t.join();
+        }
+
+        // 各区间计数 = 相邻边界的 ">=" 计数之差
+        std::vector<qint64> total(size_t(edgeCount), 0);
+        for (int c = 0; c < chunks; ++c)
+            for (int k = 0; k < edgeCount; ++k) total[k] += atLeast[size_t(c) * edgeCount + k];
+        qint64 above = n;
+        for (int k = 0; k < edgeCount; ++k) {
+            m_counts[k] = above - total[k];
+            above = total[k];
+        }
+        m_counts[edgeCount] = above;
+    }
+
+    qint64 count(int bin) const { return m_counts[bin]; }
+    qint64 total() const { return m_bins.size(); }
+
+    // 第 i 项所在区间
+    int binOf(qint64 i) const { return m_bins[i]; }
+
+    // 区间范围说明，例如 "<2元"、"2~5元"、"≥5元"
+    QString rangeLabel(int bin, const QString& unit) const {
+        if (m_edges.isEmpty()) return QString("全部");
+        auto num = [](double v) { return QString::number(v, 'g', 6); };
+        if (bin == 0) return "<" + num(m_edges.front()) + unit;
+        if (bin == binCount() - 1) return "≥" + num(m_edges.back()) + unit;
+        return num(m_edges[bin - 1]) + "~" + num(m_edges[bin]) + unit;
+    }
+
+    // 等频分箱边界：均匀抽样（最多 kQuantileSamples 个）后排序取分位点，大数组也只需毫秒级
+    template <typename T>
+    static QVector<double> quantileEdges(const T* values, qint64 n, int bins) {
+        QVector<double> edges;
+        bins = qBound(1, bins, kMaxBins);
+        if (n <= 0 || bins == 1) return edges;
+
+        qint64 step = qMax<qint64>(1, n / kQuantileSamples);
+        std::vector<double> sample;
+        sample.reserve(size_t(n / step + 1));
+        for (qint64 i = 0; i < n; i += step) sample.push_back(double(values[i]));
+        std::sort(sample.begin(), sample.end());
+
+        for (int k = 1; k < bins; ++k)
+            edges.append(sample[std::min(sample.size() - 1, sample.size() * k / bins)]);
+        return edges;
+    }
+
+    // 快照区段：BEDG 边界、BCNT 计数、BINS 每项区间号
+    void writeSnapshot(SnapshotWriter& w) const {
+        w.add("BEDG", m_edges.constData(), m_edges.size());
+        w.add("BCNT", m_counts);
+        w.add("BINS", m_bins);
+    }
+
+    // 边界和计数很小，拷贝；区间号列直接映射
+    bool mapSnapshot(const std::shared_ptr<SnapshotFile>& file) {
+        qint64 edgeCount = 0, binCount = 0;
+        const double* edges = file->section<double>("BEDG", &edgeCount);
+        const qint64* counts = file->section<qint64>("BCNT", &binCount);
+        if (!edges || !counts || binCount != edgeCount + 1 || edgeCount > kMaxBins - 1) return false;
+        if (!SnapshotFile::mapColumn(file, "BINS", m_bins)) return false;
+        if (!SnapshotFile::allBelow(m_bins, binCount)) {     // 区间号用来索引计数和颜色
+            m_bins.clear();
+            return false;
+        }
+
+        m_edges = QVector<double>(edges, edges + edgeCount);
+        m_counts.assign(counts, counts + binCount);
+        return true;
+    }
+
+private:
+    static constexpr qint64 kBlock = 4096;
+    static constexpr qint64 kParallelThreshold = 1 << 16;
+    static constexpr qint64 kQuantileSamples = 1 << 16;
+
+    QVector<double> m_edges{2.0, 5.0};
+    Column<quint8> m_bins;
+    std::vector<qint64> m_counts{0, 0, 0};
+};
@@ -0,0 +1,204 @@
+#pragma once
+
+// 耗材价格历史与多分辨率金字塔
+//
+// 每个 SKU（名称 + 规格）一条按日期排序的价格序列，可以是多年的逐日招标价。导入时自底向上逐层聚合:
+// 第 0 层为原始样本，第 k 层每个节点合并下一层相邻 4 个节点的 min/max/last，额外内存约为原始的 1/3。
+// 绘制任意时间窗口时先二分出样本范围，再选节点数不超过 每像素列 2 个 的最细一层，
+// 读取量只与图表宽度有关，与历史长度无关，从十年缩放到一天、平移都在帧预算内。
+
+#include <QDate>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QStringView>
+#include <QtGlobal>
+#include <algorithm>
+#include <vector>
+
+// 聚合节点；第 0 层 min == max == last
+struct PricePoint {
+    qint32 day = 0;         // 节点内最后一个样本的日期（儒略日）
+    float min = 0;
+    float max = 0;
+    float last = 0;         // 节点内最后一个样本的价格
+};
+
+class PricePyramid {
+public:
+    static constexpr int kFanout = 4;
+
+    // samples 会按日期稳定排序（同一天多次招标按录入顺序）
+    void build(std::vector<PricePoint> samples) {
+        std::stable_sort(samples.begin(), samples.end(),
+                         [](const PricePoint& a, const PricePoint& b) { return a.day < b.day; });
+        m_levels.clear();
+        m_levels.push_back(std::move(samples));
+        while (m_levels.back().size() > 1) {
+            const std::vector<PricePoint>& below = m_levels.back();
+            std::vector<PricePoint> level((below.size() + kFanout - 1) / kFanout);
+            for (size_t i = 0; i < level.size(); ++i) {
+                const size_t begin = i * kFanout;
+                const size_t end = qMin(below.size(), begin + kFanout);
+                PricePoint node = below[begin];
+                for (size_t j = begin + 1; j < end; ++j) {
+                    node.min = qMin(node.min, below[j].min);
+                    node.max = qMax(node.max, below[j].max);
+                }
+                node.day = below[end - 1].day;
+                node.last = below[end - 1].last;
+                level[i] = node;
+            }
+            m_levels.push_back(std::move(level));
+        }
+    }
+
+    bool empty() const { return m_levels.empty() || m_levels[0].empty(); }
+    qint64 size() const { return empty() ? 0 : qint64(m_levels[0].size()); }
+    int levelCount() const { return int(m_levels.size()); }
+    qint32 firstDay() const { return m_levels[0].front().day; }
+    qint32 lastDay() const { return m_levels[0].back().day; }
+
+    qint64 memoryBytes() const {
+        qint64 bytes = 0;
+        for (const std::vector<PricePoint>& level : m_levels) bytes += qint64(level.capacity() * sizeof(PricePoint));
+        return bytes;
+    }
+
+    // 日期窗口 [from, to] 按 columns 个像素列取点：对所选层覆盖窗口的每个节点调用 f(const PricePoint&)，
+    // 两侧各多取一个节点，折线能连到窗口边缘之外。返回所选层号，空序列返回 -1
+    template <typename F>
+    int visit(qint32 from, qint32 to, int columns, F f) const {
+        if (empty()) return -1;
+        const std::vector<PricePoint>& raw = m_levels[0];
+        auto byDay = [](const PricePoint& p, qint32 day) { return p.day < day; };
+        qint64 begin = std::lower_bound(raw.begin(), raw.end(), from, byDay) - raw.begin();
+        qint64 end = std::lower_bound(raw.begin() + begin, raw.end(), to + 1, byDay) - raw.begin();
+        begin = qMax<qint64>(0, begin - 1);
+        end = qMin<qint64>(qint64(raw.size()), end + 1);
+
+        const qint64 budget = 2 * qint64(qMax(1, columns));
+        int level = 0;
+        qint64 stride = 1;
+        while (level + 1 < levelCount() && (end - begin + stride - 1) / stride > budget) {
+            ++level;
+            stride *= kFanout;
+        }
+
+        const std::vector<PricePoint>& nodes = m_levels[size_t(level)];
+        const qint64 last = qMin<qint64>(qint64(nodes.size()), (end + stride - 1) / stride);
+        for (qint64 i = begin / stride; i < last; ++i) f(nodes[size_t(i)]);
+        return level;
+    }
+
+private:
+    std::vector<std::vector<PricePoint>> m_levels;      // [0] 为原始样本
+};
+
+class PriceHistory {
+public:
+    void clear() {
+        m_index.clear();
+        m_series.clear();
+    }
+
+    bool empty() const { return m_series.empty(); }
+    int seriesCount() const { return int(m_series.size()); }
+
+    qint64 sampleCount() const {
+        qint64 n = 0;
+        for (const PricePyramid& s : m_series) n += s.size();
+        return n;
+    }
+
+    qint64 memoryBytes() const {
+        qint64 bytes = 0;
+        for (const PricePyramid& s : m_series) bytes += s.memoryBytes();
+        return bytes;
+    }
+
+    // 按名称 + 规格找序列，没有历史返回 nullptr
+    const PricePyramid* find(QStringView name, QStringView spec) const {
+        auto it = m_index.constFind(key(name, spec));
+        return it == m_index.constEnd() ? nullptr : &m_series[size_t(it.value())];
+    }
+
+    // 同一 SKU 再次加入时替换
+    void addSeries(QStringView name, QStringView spec, std::vector<PricePoint> samples) {
+        const QString k = key(name, spec);
+        auto it = m_index.constFind(k);
+        int index = it != m_index.constEnd() ? it.value() : int(m_series.size());
+        if (index == int(m_series.size())) {
+            m_index.insert(k, index);
+            m_series.emplace_back();
+        }
+        m_series[size_t(index)].build(std::move(samples));
+    }
+
+    // 价格历史 CSV：每行 "日期,单价,名称,规格"，日期为 yyyy-MM-dd，首行表头可选。
+    // 先按 SKU 收集样本，全部读完后逐条排序、建金字塔
+    bool load(const QString& path, QString* error = nullptr) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            if (error) *error = file.errorString();
+            return false;
+        }
+
+        QHash<QString, int> index;
+        std::vector<std::vector<PricePoint>> samples;
+        std::vector<QString> names, specs;
+        while (!file.atEnd()) {
+            const QByteArray line = file.readLine();
+            const int c1 = line.indexOf(',');
+            const int c2 = c1 < 0 ? -1 : line.indexOf(',', c1 + 1);
+            const int c3 = c2 < 0 ? -1 : line.indexOf(',', c2 + 1);
+            if (c2 < 0) continue;
+
+            const qint32 day = parseDay(line.constData(), c1);
+            bool ok = false;
+            const float price = line.mid(c1 + 1, c2 - c1 - 1).trimmed().toFloat(&ok);
+            if (day == 0 || !ok) continue;     // 表头或坏行
+
+            const QString name = QString::fromUtf8(line.mid(c2 + 1, (c3 < 0 ? line.size() : c3) - c2 - 1)).trimmed();
+            const QString spec = c3 < 0 ? QString() : QString::fromUtf8(line.mid(c3 + 1)).trimmed();
+            const QString k = key(name, spec);
+            auto it = index.constFind(k);
+            if (it == index.constEnd()) {
+                it = index.insert(k, int(samples.size()));
+                samples.emplace_back();
+                names.push_back(name);
+                specs.push_back(spec);
+            }
+            samples[size_t(it.value())].push_back({day, price, price, price});
+        }
+
+        clear();
+        for (size_t i = 0; i < samples.size(); ++i) addSeries(names[i], specs[i], std::move(samples[i]));
+        return true;
+    }
+
+private:
+    QHash<QString, int> m_index;        // "名称\t规格" -> 序列号
+    std::vector<PricePyramid> m_series;
+
+    static QString key(QStringView name, QStringView spec) {
+        return name.toString() + QLatin1Char('\t') + spec.toString();
+    }
+
+    // "yyyy-MM-dd" -> 儒略日，格式不对返回 0
+    static qint32 parseDay(const char* p, int len) {
+        while (len > 0 && *p == ' ') ++p, --len;
+        if (len < 10 || p[4] != '-' || p[7] != '-') return 0;
+        auto digits = [p](int from, int count) {
+            int v = 0;
+            for (int i = from; i < from + count; ++i) {
+                if (p[i] < '0' || p[i] > '9') return -1;
+                v = v * 10 + (p[i] - '0');
+            }
+            return v;
+        };
+        const QDate date(digits(0, 4), digits(5, 2), digits(8, 2));
+        return date.isValid() ? qint32(date.toJulianDay()) : 0;
+    }
+};
@@ -0,0 +1,259 @@
+#pragma once
+
+// 看板数据快照：可直接内存映射的二进制文件，打开时不解析、不拷贝
+//
+// 小端，所有区段按 64 字节对齐:
+//   [0]   char[4]  "VSNP"
+//   [4]   quint16  版本号(1)
+//   [6]   quint16  看板类型（1 财务 / 2 耗材）
+//   [8]   quint32  区段数 N
+//   [12]  quint32  保留
+//   [16]  区段表   {char[4] 标记; quint32 元素字节数; quint64 偏移; quint64 元素个数} * N
+//   [..]  区段数据（列：价格/金额、字符串 id、字符串池偏移与 UTF-16 字符、预计算的汇总）
+//
+// 读取端用 QFile::map 映射整个文件，列直接指向映射内存（Column 视图）。
+// 映射由 shared_ptr 持有，只要还有列引用它就不会解除。
+// 快照按不可信输入处理：打开时校验区段范围，各读取方再对 id、行号、偏移列各做一遍线性检查
+// （见 allBelow），截断或损坏的文件在打开时拒绝，之后的访问不再做边界检查。
+// 大端主机上读写都会拒绝（列按主机字节序直接使用）。
+
+#include <QFile>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+#include <QtEndian>
+#include <QtGlobal>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// 列：自有 std::vector，或者指向快照映射内存的只读视图。
+// 视图上调用 mutableData() 时先拷贝成自有数据（写时复制）。
+template <typename T>
+class Column {
+public:
+    const T* data() const { return m_view ? m_view : m_own.data(); }
+    qint64 size() const { return m_view ? m_viewSize : qint64(m_own.size()); }
+    bool empty() const { return size() == 0; }
+    bool isMapped() const { return m_view != nullptr; }
+
+    const T& operator[](qint64 i) const { return data()[i]; }
+    const T& front() const { return data()[0]; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size(); }
+
+    std::vector<T>& mutableData() {
+        if (m_view) {
+            m_own.assign(m_view, m_view + m_viewSize);
+            m_view = nullptr;
+            m_viewSize = 0;
+            m_owner.reset();
+        }
+        return m_own;
+    }
+
+    void map(const T* data, qint64 size, std::shared_ptr<const void> owner) {
+        std::vector<T>().swap(m_own);
+        m_view = data;
+        m_viewSize = size;
+        m_owner = std::move(owner);
+    }
+
+    void clear() {
+        m_own.clear();
+        m_view = nullptr;
+        m_viewSize = 0;
+        m_owner.reset();
+    }
+
+    qint64 memoryBytes() const { return m_view ? 0 : qint64(m_own.capacity() * sizeof(T)); }
+
+private:
+    std::vector<T> m_own;
+    const T* m_view = nullptr;
+    qint64 m_viewSize = 0;
+    std::shared_ptr<const void> m_owner;     // 映射文件
+};
+
+class SnapshotFile {
+public:
+    static constexpr char kMagic[4] = {'V', 'S', 'N', 'P'};
+    static constexpr quint16 kVersion = 1;
+    static constexpr int kAlign = 64;
+
+    enum Kind : quint16 { Finance = 1, Medical = 2 };
+
+    struct Section {
+        char tag[4];
+        quint32 elementSize;
+        quint64 offset;
+        quint64 count;
+    };
+
+    // 映射失败、格式或版本不符时返回空，原因写入 error
+    static std::shared_ptr<SnapshotFile> open(const QString& path, Kind kind, QString* error) {
+        auto fail = [error](const QString& msg) {
+            if (error) *error = msg;
+            return std::shared_ptr<SnapshotFile>();
+        };
+        if (!hostIsLittleEndian()) return fail("大端主机不支持快照");
+
+        std::shared_ptr<SnapshotFile> s(new SnapshotFile);
+        s->m_file.setFileName(path);
+        if (!s->m_file.open(QIODevice::ReadOnly)) return fail(s->m_file.errorString());
+
+        s->m_size = s->m_file.size();
+        s->m_data = s->m_file.map(0, s->m_size);
+        if (!s->m_data) return fail("内存映射失败: " + s->m_file.errorString());
+        if (s->m_size < 16 || memcmp(s->m_data, kMagic, 4) != 0) return fail("不是快照文件");
+
+        quint16 version = qFromLittleEndian<quint16>(s->m_data + 4);
+        quint16 fileKind = qFromLittleEndian<quint16>(s->m_data + 6);
+        quint32 count = qFromLittleEndian<quint32>(s->m_data + 8);
+        if (version != kVersion) return fail(QString("快照版本 %1 不受支持").arg(version));
+        if (fileKind != kind) return fail("快照类型与看板不符");
+        if (16 + qint64(count) * qint64(sizeof(Section)) > s->m_size) return fail("区段表越界");
+
+        s->m_sections = reinterpret_cast<const Section*>(s->m_data + 16);
+        s->m_sectionCount = int(count);
+        const quint64 size = quint64(s->m_size);
+        for (int i = 0; i < s->m_sectionCount; ++i) {
+            const Section& sec = s->m_sections[i];
+            // 用除法比较，offset + count * elementSize 可能溢出回绕
+            if (sec.offset % kAlign != 0 || sec.offset > size
+                    || (sec.elementSize != 0 && sec.count > (size - sec.offset) / sec.elementSize))
+                return fail(QString("区段 %1 越界").arg(QString::fromLatin1(sec.tag, 4)));
+        }
+        return s;
+    }
+
+    // 按标记取区段；不存在或元素大小不符时返回 nullptr
+    template <typename T>
+    const T* section(const char (&tag)[5], qint64* count) const {
+        for (int i = 0; i < m_sectionCount; ++i) {
+            const Section& sec = m_sections[i];
+            if (memcmp(sec.tag, tag, 4) != 0) continue;
+            if (sec.elementSize != sizeof(T)) return nullptr;
+            if (count) *count = qint64(sec.count);
+            return reinterpret_cast<const T*>(m_data + sec.offset);
+        }
+        return nullptr;
+    }
+
+    // 把区段映射成列；owner 是持有本文件的 shared_ptr
+    template <typename T>
+    static bool mapColumn(const std::shared_ptr<SnapshotFile>& owner, const char (&tag)[5], Column<T>& column) {
+        qint64 count = 0;
+        const T* data = owner->section<T>(tag, &count);
+        if (!data) return false;
+        column.map(data, count, owner);
+        return true;
+    }
+
+    // 映射进来的 id / 行号列每个值都小于 limit；打开快照时校验一遍，之后按下标访问不越界
+    template <typename T>
+    static bool allBelow(const Column<T>& column, qint64 limit) {
+        return std::all_of(column.begin(), column.end(), [limit](T v) { return qint64(v) < limit; });
+    }
+
+    static bool hostIsLittleEndian() { return Q_BYTE_ORDER == Q_LITTLE_ENDIAN; }
+
+private:
+    SnapshotFile() = default;
+
+    QFile m_file;
+    const uchar* m_data = nullptr;
+    qint64 m_size = 0;
+    const Section* m_sections = nullptr;
+    int m_sectionCount = 0;
+};
+
+// 写快照：登记各区段（只记指针，不拷贝），finish() 时顺序写出
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(SnapshotFile::Kind kind) : m_kind(kind) {}
+
+    // 数据须在 finish() 之前保持有效
+    template <typename T>
+    void add(const char (&tag)[5], const T* data, qint64 count) {
+        Pending p;
+        memcpy(p.tag, tag, 4);
+        p.elementSize = sizeof(T);
+        p.data = data;
+        p.count = count;
+        m_pending.push_back(p);
+    }
+
+    template <typename T>
+    void add(const char (&tag)[5], const Column<T>& column) { add(tag, column.data(), column.size()); }
+
+    template <typename T>
+    void add(const char (&tag)[5], const std::vector<T>& v) { add(tag, v.data(), qint64(v.size())); }
+
+    bool finish(const QString& path, QString* error = nullptr) {
+        auto fail = [&](const QString& msg) {
+            if (error) *error = msg;
+            return false;
+        };
+        if (!SnapshotFile::hostIsLittleEndian()) return fail("大端主机不支持快照");
+
+        QFile out(path);
+        if (!out.open(QIODevice::WriteOnly)) return fail(out.errorString());
+
+        // 先算好各区段偏移，区段表和数据一次写出
+        std::vector<SnapshotFile::Section> table(m_pending.size());
+        quint64 offset = align(16 + quint64(table.size()) * sizeof(SnapshotFile::Section));
+        for (size_t i = 0; i < m_pending.size(); ++i) {
+            const Pending& p = m_pending[i];
+            memcpy(table[i].tag, p.tag, 4);
+            table[i].elementSize = p.elementSize;
+            table[i].offset = offset;
+            table[i].count = quint64(p.count);
+            offset = align(offset + quint64(p.count) * p.elementSize);
+        }
+
+        char header[16] = {};
+        memcpy(header, SnapshotFile::kMagic, 4);
+        qToLittleEndian<quint16>(SnapshotFile::kVersion, header + 4);
+        qToLittleEndian<quint16>(m_kind, header + 6);
+        qToLittleEndian<quint32>(quint32(table.size()), header + 8);
+        bool ok = out.write(header, 16) == 16;
+        ok = ok && out.write(reinterpret_cast<const char*>(table.data()),
+                             qint64(table.size() * sizeof(SnapshotFile::Section))) >= 0;
+
+        for (size_t i = 0; ok && i < m_pending.size(); ++i) {
+            ok = pad(out, table[i].offset);
+            const char* bytes = static_cast<const char*>(m_pending[i].data);
+            qint64 remaining = m_pending[i].count * qint64(m_pending[i].elementSize);
+            while (ok && remaining > 0) {     // 分块写，单次不超过 64MB
+                qint64 n = qMin<qint64>(remaining, 64 << 20);
+                ok = out.write(bytes, n) == n;
+                bytes += n;
+                remaining -= n;
+            }
+        }
+        ok = ok && pad(out, offset);
+        if (!ok) return fail(out.errorString());
+        return true;
+    }
+
+private:
+    struct Pending {
+        char tag[4];
+        quint32 elementSize;
+        const void* data;
+        qint64 count;
+    };
+
+    SnapshotFile::Kind m_kind;
+    std::vector<Pending> m_pending;
+
+    static quint64 align(quint64 v) { return (v + SnapshotFile::kAlign - 1) / SnapshotFile::kAlign * SnapshotFile::kAlign; }
+
+    static bool pad(QFile& out, quint64 to) {
+        static const char zeros[SnapshotFile::kAlign] = {};
+        qint64 gap = qint64(to) - out.pos();
+        return gap >= 0 && gap < SnapshotFile::kAlign && (gap == 0 || out.write(zeros, gap) == gap);
+    }
+};
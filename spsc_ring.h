@@ -0,0 +1,69 @@
+#pragma once
+
+// 单生产者单消费者无锁环形队列
+//
+// 容量取 2 的幂，读写下标单调递增、按掩码取槽位。生产端和消费端各自缓存一份对方的下标，
+// 只在看起来满/空时才去读对方的原子变量，两端的下标分在不同缓存行，避免来回争用。
+// 只允许一个线程 tryPush、一个线程 popAll。
+
+#include <QtGlobal>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t n = 2;
+        while (n < capacity) n <<= 1;
+        m_slots.resize(n);
+        m_mask = n - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    // 生产端：满时返回 false，value 保持不动
+    bool tryPush(T&& value) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache > m_mask) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache > m_mask) return false;
+        }
+        m_slots[tail & m_mask] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费端：取出当前已有的元素（最多 max 个），对每个调用 f(T&)，可以从中移走内容；返回个数
+    template <typename F>
+    size_t popAll(F f, size_t max = size_t(-1)) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (m_tailCache == head) m_tailCache = m_tail.load(std::memory_order_acquire);
+        const size_t n = qMin(m_tailCache - head, max);
+        for (size_t i = 0; i < n; ++i) f(m_slots[(head + i) & m_mask]);
+        m_head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // 近似元素数（任一端都可调用，仅用于统计）
+    size_t sizeApprox() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    std::vector<T> m_slots;
+    size_t m_mask = 0;
+
+    alignas(kCacheLine) std::atomic<size_t> m_tail{0};     // 生产端写
+    size_t m_headCache = 0;                                 // 生产端缓存的 m_head
+
+    alignas(kCacheLine) std::atomic<size_t> m_head{0};     // 消费端写
+    size_t m_tailCache = 0;                                 // 消费端缓存的 m_tail
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+// 字符串驻留池：相同内容只存一份，按 32 位 id 引用
+//
+// 自有模式下字符存放在 64K 字符的 arena 块里，块地址固定，视图和去重哈希的键长期有效。
+// 也可以直接映射快照里的 {偏移表, UTF-16 字符区}，此时只读，不能再 intern。
+
+#include <QHash>
+#include <QString>
+#include <QStringView>
+#include <QtGlobal>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "snapshot.h"
+
+class StringPool {
+public:
+    static constexpr qsizetype kBlockChars = 64 * 1024;
+
+    // 相同内容返回同一 id
+    quint32 intern(QStringView s) {
+        Q_ASSERT(!isMapped());
+        auto it = m_index.constFind(s);
+        if (it != m_index.constEnd()) return it.value();
+
+        const QChar* stored = store(s);
+        quint32 id = quint32(m_entries.size());
+        m_entries.push_back({stored, quint32(s.size())});
+        m_index.insert(QStringView(stored, s.size()), id);
+        return id;
+    }
+
+    QStringView view(quint32 id) const {
+        if (isMapped()) {
+            const QChar* chars = reinterpret_cast<const QChar*>(m_mappedChars.data());
+            return QStringView(chars + m_mappedOffsets[id], qsizetype(m_mappedOffsets[id + 1] - m_mappedOffsets[id]));
+        }
+        const Entry& e = m_entries[id];
+        return QStringView(e.data, qsizetype(e.length));
+    }
+
+    int size() const { return isMapped() ? int(m_mappedOffsets.size() - 1) : int(m_entries.size()); }
+    bool isMapped() const { return m_mappedOffsets.isMapped(); }
+
+    void clear() {
+        m_index.clear();
+        m_entries.clear();
+        m_blocks.clear();
+        m_current = nullptr;
+        m_used = kBlockChars;
+        m_arenaChars = 0;
+        m_mappedOffsets.clear();
+        m_mappedChars.clear();
+    }
+
+    // 近似占用：arena + 条目表 + 去重哈希；映射模式不占堆内存
+    qint64 memoryBytes() const {
+        return m_arenaChars * qint64(sizeof(QChar))
+               + qint64(m_entries.capacity() * sizeof(Entry))
+               + qint64(m_index.capacity()) * qint64(sizeof(QStringView) + sizeof(quint32) + 2 * sizeof(void*));
+    }
+
+    // 快照区段：偏移表 size()+1 项，字符区为连续 UTF-16
+    void writeSnapshot(SnapshotWriter& w, std::vector<quint32>& offsets, std::vector<char16_t>& chars) const {
+        offsets.assign(1, 0);
+        offsets.reserve(size_t(size()) + 1);
+        chars.clear();
+        for (quint32 id = 0; id < quint32(size()); ++id) {
+            QStringView v = view(id);
+            chars.insert(chars.end(), v.utf16(), v.utf16() + v.size());
+            offsets.push_back(quint32(chars.size()));
+        }
+        w.add("SOFF", offsets);
+        w.add("SCHR", chars);
+    }
+
+    // 偏移表须单调不减且不超出字符区，否则 view() 会越界
+    bool mapSnapshot(const std::shared_ptr<SnapshotFile>& file) {
+        clear();
+        if (!SnapshotFile::mapColumn(file, "SOFF", m_mappedOffsets)
+                || !SnapshotFile::mapColumn(file, "SCHR", m_mappedChars)
+                || m_mappedOffsets.empty()
+                || !std::is_sorted(m_mappedOffsets.begin(), m_mappedOffsets.end())
+                || qint64(m_mappedOffsets[m_mappedOffsets.size() - 1]) > m_mappedChars.size()) {
+            clear();
+            return false;
+        }
+        return true;
+    }
+
+private:
+    struct Entry {
+        const QChar* data;
+        quint32 length;
+    };
+
+    std::vector<std::unique_ptr<QChar[]>> m_blocks;
+    QChar* m_current = nullptr;
+    qsizetype m_used = kBlockChars;
+    qint64 m_arenaChars = 0;
+    std::vector<Entry> m_entries;
+    QHash<QStringView, quint32> m_index;
+
+    Column<quint32> m_mappedOffsets;    // 映射模式
+    Column<char16_t> m_mappedChars;
+
+    const QChar* store(QStringView s) {
+        static const QChar empty;
+        if (s.isEmpty()) return &empty;
+
+        // 超长字符串单独一块，不打断当前块
+        if (s.size() > kBlockChars / 4) {
+            m_blocks.emplace_back(new QChar[size_t(s.size())]);
+            m_arenaChars += s.size();
+            std::copy(s.begin(), s.end(), m_blocks.back().get());
+            return m_blocks.back().get();
+        }
+        if (m_used + s.size() > kBlockChars) {
+            m_blocks.emplace_back(new QChar[size_t(kBlockChars)]);
+            m_arenaChars += kBlockChars;
+            m_current = m_blocks.back().get();
+            m_used = 0;
+        }
+        QChar* dst = m_current + m_used;
+        std::copy(s.begin(), s.end(), dst);
+        m_used += s.size();
+        return dst;
+    }
+};
@@ -0,0 +1,173 @@
+#pragma once
+
+// 表格节点（虚拟滚动）
+//
+// 只为可见行取数：重建时按 TableViewport 的可见区间调用绑定，把每格的文字、颜色、
+// 对齐和字号缓存下来。滚动只使本节点失效，且只重绘表体，表头和标题不动。
+// 行高固定，鼠标命中由视口偏移直接算出行号，与总行数无关。
+
+#include <QLinearGradient>
+#include <QPainterPath>
+#include <vector>
+#include "chart_scene.h"
+#include "hit_index.h"
+#include "table_viewport.h"
+
+class TableNode : public ChartNode {
+public:
+    struct Column {
+        QString header;
+        int width;
+        Qt::Alignment headerAlign;
+    };
+
+    struct Cell {
+        QString text;
+        QColor color = Qt::white;
+        Qt::Alignment align = Qt::AlignLeft | Qt::AlignVCenter;
+        int fontSize = 10;
+        int fontWeight = QFont::Normal;
+    };
+
+    struct Style {
+        int headerTop = 30;         // 表头离边框顶部（上面是标题）
+        int headerHeight = 35;
+        QColor headerColor = QColor(60, 80, 120, 200);
+        QColor headerColor2;        // 有效时表头自上而下渐变到这个颜色
+        QColor headerTextColor = QColor(220, 240, 255);
+        int headerFontSize = 11;
+        QColor evenRow = QColor(40, 45, 70, 150);
+        QColor oddRow = QColor(50, 55, 80, 150);
+        int textLeft = 10;          // 第一列离边框左侧
+    };
+
+    Style style;
+    std::vector<Column> columns;
+
+    // 数据绑定：cells 按列顺序填满第 row 行
+    std::function<qint64()> rowCount;
+    std::function<void(qint64 row, std::vector<Cell>& cells)> cells;
+
+    TableNode(const char* name, const QRect& bounds, int rowHeight)
+        : ChartNode(name, bounds), m_view(rowHeight) {}
+
+    const TableViewport& viewport() const { return m_view; }
+
+    // 表体：去掉标题区、表头和底部留白(5)
+    QRect bodyRect() const { return bounds().adjusted(0, style.headerTop + style.headerHeight, 0, -5); }
+
+    // 返回是否需要重绘；需要时只有表体标脏
+    bool scrollBy(qint64 dy) {
+        if (!m_view.scrollBy(dy)) return false;
+        invalidate(bodyRect());
+        return true;
+    }
+
+    bool scrollTo(qint64 offset) {
+        if (!m_view.scrollTo(offset)) return false;
+        invalidate(bodyRect());
+        return true;
+    }
+
+    // 鼠标所在的行，不在表体内（表头、空白处）返回无效结果
+    ChartHit hitTest(const QPoint& pos) const {
+        const QRect body = bodyRect();
+        if (!isVisible() || !body.contains(pos)) return {};
+        const qint64 row = m_view.rowAt(pos.y() - body.top());
+        if (row < 0) return {};
+        return {int(row), int(row), int(row)};
+    }
+
+    // 命中行的高亮轮廓，裁到表体内
+    QPainterPath hitShape(const ChartHit& hit) const {
+        QPainterPath path;
+        if (!hit.isValid()) return path;
+        const QRect body = bodyRect();
+        const QRect row = QRect(body.left(), body.top() + m_view.rowTop(hit.slot), body.width(), m_view.rowHeight()) & body;
+        if (!row.isEmpty()) path.addRect(QRectF(row).adjusted(1.5, 0.5, -1.5, -0.5));
+        return path;
+    }
+
+    void paint(QPainter& p) const override {
+        paintFrame(p);
+
+        // 表头
+        const QRect& area = bounds();
+        const int rowHeight = m_view.rowHeight();
+        const int headerY = area.top() + style.headerTop;
+        p.setBrush(m_headerBrush);
+        p.setPen(Qt::NoPen);
+        p.drawRect(area.left(), headerY, area.width(), style.headerHeight);
+
+        p.setPen(style.headerTextColor);
+        p.setFont(vizFont(style.headerFontSize, QFont::Bold));
+        int x = area.left() + style.textLeft;
+        for (const Column& column : columns) {
+            drawCachedText(p, x, headerY, column.width, style.headerHeight, column.headerAlign, column.header);
+            x += column.width;
+        }
+
+        // 数据行
+        const QRect body = bodyRect();
+        p.save();
+        p.setClipRect(body, Qt::IntersectClip);
+        for (const CachedRow& row : m_rows) {
+            const int y = body.top() + m_view.rowTop(row.row);
+
+            // 交替行背景
+            p.setBrush(row.row % 2 == 0 ? style.evenRow : style.oddRow);
+            p.setPen(Qt::NoPen);
+            p.drawRect(area.left(), y, area.width(), rowHeight);
+
+            x = area.left() + style.textLeft;
+            for (size_t c = 0; c < row.cells.size() && c < columns.size(); ++c) {
+                const Cell& cell = row.cells[c];
+                p.setPen(cell.color);
+                p.setFont(vizFont(cell.fontSize, cell.fontWeight));
+                drawCachedText(p, x, y, columns[c].width, rowHeight, cell.align, cell.text);
+                x += columns[c].width;
+            }
+        }
+        p.restore();
+
+        m_view.drawScrollBar(p, body);
+    }
+
+protected:
+    void rebuild() override {
+        const QRect& area = bounds();
+        const int headerY = area.top() + style.headerTop;
+        if (style.headerColor2.isValid()) {
+            QLinearGradient headerGrad(area.left(), headerY, area.left(), headerY + style.headerHeight);
+            headerGrad.setColorAt(0.0, style.headerColor);
+            headerGrad.setColorAt(1.0, style.headerColor2);
+            m_headerBrush = QBrush(headerGrad);
+        } else {
+            m_headerBrush = QBrush(style.headerColor);
+        }
+
+        m_view.setRowCount(rowCount ? rowCount() : 0);
+        m_view.setViewportHeight(bodyRect().height());
+
+        // 只格式化可见行
+        const qint64 first = m_view.firstVisibleRow();
+        const qint64 last = m_view.lastVisibleRow();
+        m_rows.resize(size_t(qMax<qint64>(0, last - first + 1)));
+        for (qint64 row = first; row <= last; ++row) {
+            CachedRow& cached = m_rows[size_t(row - first)];
+            cached.row = row;
+            cached.cells.clear();
+            cells(row, cached.cells);
+        }
+    }
+
+private:
+    struct CachedRow {
+        qint64 row = 0;
+        std::vector<Cell> cells;
+    };
+
+    TableViewport m_view;
+    QBrush m_headerBrush;
+    std::vector<CachedRow> m_rows;
+};
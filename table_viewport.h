@@ -0,0 +1,84 @@
+#pragma once
+
+// 表格虚拟滚动：固定行高模型 + 像素滚动偏移
+// 绘制时只遍历 [firstVisibleRow, lastVisibleRow]，开销只与视口高度有关，与总行数无关。
+
+#include <QColor>
+#include <QPainter>
+#include <QRect>
+#include <QtGlobal>
+
+class TableViewport {
+public:
+    explicit TableViewport(int rowHeight = 40) : m_rowHeight(rowHeight) {}
+
+    void setRowCount(qint64 count) {
+        m_rowCount = qMax<qint64>(0, count);
+        clamp();
+    }
+
+    void setViewportHeight(int height) {
+        m_viewportHeight = qMax(0, height);
+        clamp();
+    }
+
+    int rowHeight() const { return m_rowHeight; }
+    qint64 rowCount() const { return m_rowCount; }
+    qint64 scrollOffset() const { return m_scroll; }
+
+    qint64 contentHeight() const { return m_rowCount * m_rowHeight; }
+    qint64 maxScroll() const { return qMax<qint64>(0, contentHeight() - m_viewportHeight); }
+    bool scrollable() const { return maxScroll() > 0; }
+
+    // 返回偏移是否变化，调用方据此决定是否重绘
+    bool scrollBy(qint64 dy) { return scrollTo(m_scroll + dy); }
+
+    bool scrollTo(qint64 offset) {
+        qint64 old = m_scroll;
+        m_scroll = offset;
+        clamp();
+        return m_scroll != old;
+    }
+
+    qint64 firstVisibleRow() const { return m_scroll / m_rowHeight; }
+
+    qint64 lastVisibleRow() const {
+        if (m_rowCount == 0) return -1;
+        return qMin(m_rowCount - 1, (m_scroll + m_viewportHeight - 1) / m_rowHeight);
+    }
+
+    // 行顶部相对于表体顶部的 y 坐标
+    int rowTop(qint64 row) const { return int(row * m_rowHeight - m_scroll); }
+
+    // 表体内 y 坐标对应的行号，越界返回 -1
+    qint64 rowAt(int y) const {
+        if (y < 0 || y >= m_viewportHeight) return -1;
+        qint64 row = (m_scroll + y) / m_rowHeight;
+        return row < m_rowCount ? row : -1;
+    }
+
+    // 右侧细滚动条
+    void drawScrollBar(QPainter& p, const QRect& body) const {
+        if (!scrollable()) return;
+
+        int trackX = body.right() - 6;
+        int thumbH = qMax(20, int(qint64(body.height()) * m_viewportHeight / contentHeight()));
+        int thumbY = body.top() + int((body.height() - thumbH) * m_scroll / maxScroll());
+
+        p.save();
+        p.setPen(Qt::NoPen);
+        p.setBrush(QColor(255, 255, 255, 25));
+        p.drawRoundedRect(trackX, body.top(), 4, body.height(), 2, 2);
+        p.setBrush(QColor(255, 255, 255, 120));
+        p.drawRoundedRect(trackX, thumbY, 4, thumbH, 2, 2);
+        p.restore();
+    }
+
+private:
+    int m_rowHeight;
+    qint64 m_rowCount = 0;
+    int m_viewportHeight = 0;
+    qint64 m_scroll = 0;
+
+    void clamp() { m_scroll = qBound<qint64>(0, m_scroll, maxScroll()); }
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+// 太极图贴图
+//
+// 阴阳鱼按真正的 S 形曲线构造：上半圆 ∪ 右侧小圆 − 左侧小圆 为阳（白），其余为阴（黑），
+// 两个鱼眼在小圆圆心。路径按单位半径只构建一次，栅格化时按像素半径缩放。
+//
+// 两种缓存方式:
+//   Exact       按当前半径 × DPR 精确栅格化一张，半径或 DPR 变化时重画（默认，最清晰）
+//   Mipmapped   按 16、32 … 2048 像素半径的 2 的幂级数各画一张（用到时才画），
+//               取不小于目标半径的最近一级缩小绘制；改变窗口大小时不再重新栅格化曲线
+
+#include <QImage>
+#include <QMap>
+#include <QPainter>
+#include <QPainterPath>
+#include <QtMath>
+#include <cmath>
+
+class TaijiSprite {
+public:
+    enum Mode { Exact, Mipmapped };
+
+    static constexpr int kMinLevel = 4;     // 2^4 = 16 像素半径
+    static constexpr int kMaxLevel = 11;    // 2^11 = 2048 像素半径，更大的按 Exact 画
+    static constexpr double kMargin = 2;    // 贴图四周留白（像素），容纳描边和旋转采样
+
+    void setMode(Mode mode) {
+        if (mode == m_mode) return;
+        m_mode = mode;
+        m_exact = QImage();
+        m_levels.clear();
+    }
+
+    Mode mode() const { return m_mode; }
+
+    // 以 painter 当前原点为圆心画半径 radius（逻辑像素）的太极图，调用方负责平移/旋转
+    void draw(QPainter& p, double radius, qreal dpr) {
+        const double pixelRadius = radius * dpr;
+        double spriteRadius = pixelRadius;
+        const QImage& image = spriteFor(pixelRadius, &spriteRadius);
+        if (image.isNull()) return;
+
+        // 贴图像素 -> 逻辑坐标；Exact 时比例为 1/dpr，未旋转时与像素网格对齐
+        const double half = image.width() / 2.0 * (pixelRadius / spriteRadius) / dpr;
+        if (spriteRadius != pixelRadius) p.setRenderHint(QPainter::SmoothPixmapTransform);
+        p.drawImage(QRectF(-half, -half, half * 2, half * 2), image);
+    }
+
+    // 外圈描边粗细随半径（原先 233 像素半径时 2 像素）
+    static double outlineWidth(double radius) { return qMax(1.0, radius / 116); }
+
+    // 含描边和留白的外接半径，即贴图的半边长；动画时重绘这个范围即可
+    static double extent(double radius) { return radius + outlineWidth(radius) / 2 + kMargin; }
+
+    // 单位半径、圆心在原点的阳鱼（白）路径
+    static const QPainterPath& yangPath() {
+        static const QPainterPath path = [] {
+            QPainterPath yang;
+            yang.moveTo(1, 0);
+            yang.arcTo(QRectF(-1, -1, 2, 2), 0, 180);           // 上半大圆：右 -> 左
+            yang.arcTo(QRectF(-1, -0.5, 1, 1), 180, -180);      // 左小圆上缘：-> 圆心
+            yang.arcTo(QRectF(0, -0.5, 1, 1), 180, 180);        // 右小圆下缘：-> 右
+            yang.closeSubpath();
+            return yang;
+        }();
+        return path;
+    }
+
+private:
+    Mode m_mode = Exact;
+    QImage m_exact;
+    double m_exactRadius = 0;
+    QMap<int, QImage> m_levels;     // 级数 -> 贴图
+
+    const QImage& spriteFor(double pixelRadius, double* spriteRadius) {
+        static const QImage none;
+        if (pixelRadius < 1) return none;
+
+        if (m_mode == Mipmapped) {
+            int level = qMax(kMinLevel, int(std::ceil(std::log2(pixelRadius))));
+            if (level <= kMaxLevel) {
+                auto it = m_levels.find(level);
+                if (it == m_levels.end()) it = m_levels.insert(level, render(double(1 << level)));
+                *spriteRadius = double(1 << level);
+                return it.value();
+            }
+        }
+
+        if (m_exact.isNull() || m_exactRadius != pixelRadius) {
+            m_exact = render(pixelRadius);
+            m_exactRadius = pixelRadius;
+        }
+        *spriteRadius = pixelRadius;
+        return m_exact;
+    }
+
+    // 按像素半径栅格化，圆心在贴图正中
+    static QImage render(double pixelRadius) {
+        const int size = int(std::ceil(2 * extent(pixelRadius)));
+        QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+
+        QPainter p(&image);
+        p.setRenderHint(QPainter::Antialiasing);
+        p.translate(size / 2.0, size / 2.0);
+
+        // 阴（黑）底 + 阳（白）鱼
+        p.setPen(Qt::NoPen);
+        p.setBrush(Qt::black);
+        p.drawEllipse(QPointF(0, 0), pixelRadius, pixelRadius);
+        p.setBrush(Qt::white);
+        p.drawPath(QTransform::fromScale(pixelRadius, pixelRadius).map(yangPath()));
+
+        // 鱼眼：阳鱼头里是阴眼，阴鱼头里是阳眼
+        const double eye = pixelRadius / 8;
+        p.setBrush(Qt::black);
+        p.drawEllipse(QPointF(pixelRadius / 2, 0), eye, eye);
+        p.setBrush(Qt::white);
+        p.drawEllipse(QPointF(-pixelRadius / 2, 0), eye, eye);
+
+        // 外圈描边
+        p.setBrush(Qt::NoBrush);
+        p.setPen(QPen(Qt::white, outlineWidth(pixelRadius)));
+        p.drawEllipse(QPointF(0, 0), pixelRadius, pixelRadius);
+        return image;
+    }
+};
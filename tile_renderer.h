@@ -0,0 +1,94 @@
+#pragma once
+
+// 分块并行光栅化
+//
+// 把脏区切成固定大小的网格块，每块在线程池里画到自己的 QImage 上
+// （画家平移到块原点并裁剪到块内脏区），全部完成后在调用线程按块贴回目标。
+// paint(QPainter&, QRect) 会被多个线程同时调用，必须是只读的：
+// 调用方先在本线程把所有惰性缓存（静态层、排名快照、LOD 路径等）准备好。
+
+#include <QImage>
+#include <QPainter>
+#include <QRect>
+#include <QThread>
+#include <QThreadPool>
+#include <vector>
+
+class TileRenderer {
+public:
+    explicit TileRenderer(int tileSize = 256, int threads = QThread::idealThreadCount())
+        : m_tileSize(qMax(32, tileSize)) {
+        m_pool.setMaxThreadCount(qMax(1, threads));
+        m_pool.setExpiryTimeout(-1);   // 线程常驻，线程内的文本/字体缓存才能跨帧复用
+    }
+
+    int tileSize() const { return m_tileSize; }
+    void setTileSize(int size) { m_tileSize = qMax(32, size); }
+
+    int threadCount() const { return m_pool.maxThreadCount(); }
+    void setThreadCount(int n) { m_pool.setMaxThreadCount(qMax(1, n)); }
+
+    // 上一帧切出的块数
+    int lastTileCount() const { return m_lastTileCount; }
+
+    template <typename Paint>
+    void render(QPainter& target, const QRect& dirty, qreal dpr, Paint paint) {
+        // 网格按逻辑坐标对齐，块原点在 tileSize 的整数倍上，相邻帧同一位置的块缓冲可复用
+        struct Tile { QRect cell; QRect part; };
+        std::vector<Tile> tiles;
+        const int ts = m_tileSize;
+        for (int y = floorDiv(dirty.top(), ts) * ts; y <= dirty.bottom(); y += ts) {
+            for (int x = floorDiv(dirty.left(), ts) * ts; x <= dirty.right(); x += ts) {
+                QRect cell(x, y, ts, ts);
+                tiles.push_back({cell, cell & dirty});
+            }
+        }
+        m_lastTileCount = int(tiles.size());
+        if (tiles.empty()) return;
+
+        // 只有一块或单线程时直接画，省掉中间缓冲
+        if (tiles.size() == 1 || threadCount() == 1) {
+            target.save();
+            target.setClipRect(dirty, Qt::IntersectClip);
+            paint(target, dirty);
+            target.restore();
+            return;
+        }
+
+        if (m_buffers.size() < tiles.size()) m_buffers.resize(tiles.size());
+        const QSize pixelSize = (QSizeF(ts, ts) * dpr).toSize();
+
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            m_pool.start([this, &tiles, &paint, i, dpr, pixelSize] {
+                const Tile& t = tiles[i];
+                QImage& image = m_buffers[i];
+                if (image.size() != pixelSize || image.devicePixelRatio() != dpr) {
+                    image = QImage(pixelSize, QImage::Format_ARGB32_Premultiplied);
+                    image.setDevicePixelRatio(dpr);
+                }
+                image.fill(Qt::transparent);
+
+                QPainter p(&image);
+                p.translate(-t.cell.topLeft());
+                p.setClipRect(t.part);
+                paint(p, t.part);
+            });
+        }
+        m_pool.waitForDone();
+
+        // 贴回：只拷贝块内脏区部分
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            const Tile& t = tiles[i];
+            QPointF src = QPointF(t.part.topLeft() - t.cell.topLeft()) * dpr;
+            target.drawImage(QRectF(t.part), m_buffers[i], QRectF(src, QSizeF(t.part.size()) * dpr));
+        }
+    }
+
+private:
+    int m_tileSize;
+    int m_lastTileCount = 0;
+    QThreadPool m_pool;
+    std::vector<QImage> m_buffers;   // 按块序号复用的离屏缓冲
+
+    static int floorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+// 文本排版缓存 + 字体/画笔资源池，供各个图表共用
+//
+// 中文字形排版(shaping)是绘制的主要开销。TextCache 以 (字符串, 字体, DPR, 折行宽度)
+// 为键缓存预排版的 QStaticText，之后每帧只做字形贴图。数据或字体变了键就变，
+// 旧条目由 LRU 自然淘汰。缓存按线程独立，离屏/分块渲染线程各自持有一份。
+
+#include <QCache>
+#include <QFont>
+#include <QHash>
+#include <QPainter>
+#include <QPen>
+#include <QStaticText>
+#include <QString>
+#include <QTextOption>
+
+static const char* const kVizFontFamily = "Microsoft YaHei";
+
+// 字体池：同一 (字号, 字重) 只构造一次
+inline const QFont& vizFont(int pointSize, int weight = QFont::Normal) {
+    thread_local QHash<int, QFont> pool;
+    int key = (pointSize << 10) | weight;
+    auto it = pool.find(key);
+    if (it == pool.end()) it = pool.insert(key, QFont(kVizFontFamily, pointSize, weight));
+    return it.value();
+}
+
+// 画笔池：同一 (颜色, 线宽) 只构造一次
+inline const QPen& vizPen(const QColor& color, qreal width = 1) {
+    thread_local QHash<quint64, QPen> pool;
+    quint64 key = (quint64(color.rgba()) << 32) | quint32(qRound(width * 100));
+    auto it = pool.find(key);
+    if (it == pool.end()) it = pool.insert(key, QPen(color, width));
+    return it.value();
+}
+
+class TextCache {
+public:
+    static TextCache& instance() {
+        thread_local TextCache cache;
+        return cache;
+    }
+
+    void setMaxEntries(int n) { m_cache.setMaxCost(n); }
+    void clear() { m_cache.clear(); }
+    int size() const { return m_cache.size(); }
+
+    // 与 QPainter::drawText(rect, flags, text) 对齐方式一致，使用画家当前字体和画笔
+    void drawText(QPainter& p, const QRectF& rect, int flags, const QString& text) {
+        if (text.isEmpty()) return;
+
+        bool wrap = flags & Qt::TextWordWrap;
+        Key key{text, p.font(), p.device() ? p.device()->devicePixelRatioF() : 1.0,
+                wrap ? qRound(rect.width()) : -1};
+
+        QStaticText* st = m_cache.object(key);
+        if (!st) {
+            st = new QStaticText(text);
+            st->setTextFormat(Qt::PlainText);
+            st->setPerformanceHint(QStaticText::AggressiveCaching);
+            if (wrap) {
+                st->setTextWidth(rect.width());
+                st->setTextOption(QTextOption(Qt::Alignment(flags & Qt::AlignHorizontal_Mask)));
+            }
+            st->prepare(p.transform(), p.font());
+            m_cache.insert(key, st);
+        }
+
+        QSizeF size = st->size();
+        // 放不下时退回普通 drawText，保留原来的裁剪效果
+        if (size.width() > rect.width() + 0.5 || size.height() > rect.height() + 0.5) {
+            p.drawText(rect, flags, text);
+            return;
+        }
+
+        qreal x = rect.left();
+        if (!wrap) {
+            if (flags & Qt::AlignRight) x = rect.right() - size.width();
+            else if (flags & Qt::AlignHCenter) x = rect.left() + (rect.width() - size.width()) / 2;
+        }
+        qreal y = rect.top();
+        if (flags & Qt::AlignBottom) y = rect.bottom() - size.height();
+        else if (flags & Qt::AlignVCenter) y = rect.top() + (rect.height() - size.height()) / 2;
+
+        p.drawStaticText(QPointF(x, y), *st);
+    }
+
+private:
+    struct Key {
+        QString text;
+        QFont font;
+        qreal dpr;
+        int wrapWidth;
+
+        bool operator==(const Key& o) const {
+            return wrapWidth == o.wrapWidth && dpr == o.dpr && text == o.text && font == o.font;
+        }
+    };
+
+    friend uint qHash(const Key& k, uint seed = 0) {
+        return qHash(k.text, seed) ^ qHash(k.font, seed) ^ uint(k.wrapWidth * 31) ^ uint(k.dpr * 100);
+    }
+
+    TextCache() : m_cache(4096) {}
+
+    QCache<Key, QStaticText> m_cache;
+};
+
+inline void drawCachedText(QPainter& p, const QRectF& rect, int flags, const QString& text) {
+    TextCache::instance().drawText(p, rect, flags, text);
+}
+
+inline void drawCachedText(QPainter& p, qreal x, qreal y, qreal w, qreal h, int flags, const QString& text) {
+    TextCache::instance().drawText(p, QRectF(x, y, w, h), flags, text);
+}